@@ -3,6 +3,8 @@
 #include <asyncnet/Requestor.hpp>
 #include <asyncnet/Request.hpp>
 
+#include <chrono>
+#include <exception>
 #include <list>
 #include <vector>
 #include <string>
@@ -12,9 +14,33 @@
 
 namespace asyncnet {
 
+	/**
+	 * Result of @ref AsyncSession::warm_up for one origin. Times are the longest of all origin connections
+	 */
+	struct WarmUpResult {
+		/// Warmed up origin
+		std::string origin;
+		/// Count of connections opened and left in the connection caches of all loops or workers
+		unsigned connections = 0;
+		/// Time until host name was resolved
+		std::chrono::microseconds name_lookup_time{};
+		/// Time until TCP connection was established
+		std::chrono::microseconds connect_time{};
+		/// Time until TLS handshake was done. Zero for plain HTTP
+		std::chrono::microseconds tls_time{};
+		/// Time until connection was checked with request
+		std::chrono::microseconds total_time{};
+		/// First error of origin connections, nullptr if all connected
+		std::exception_ptr error;
+	};
+
 	class AsyncSession : Requestor {
 	public:
-		explicit AsyncSession(const unsigned worker_count);
+		explicit AsyncSession(const unsigned worker_count, const RequestorEngine engine = RequestorEngine::ThreadPool);
+#if defined(__linux__)
+		/// @copydoc Requestor::Requestor(scheduler)
+		explicit AsyncSession(std::shared_ptr<coro::io_scheduler> scheduler);
+#endif
 		explicit AsyncSession(Requestor&& requestor);
 		AsyncSession(const AsyncSession& other) = default;
 		AsyncSession(AsyncSession&& other) = default;
@@ -29,6 +55,21 @@ namespace asyncnet {
 		/// @copydoc Request::set_timeout(timeout)
 		void set_timeout(const std::optional<std::chrono::system_clock::duration>& timeout);
 
+		/// @copydoc Request::set_connect_timeout(timeout)
+		void set_connect_timeout(const std::optional<std::chrono::system_clock::duration>& timeout);
+
+		/// @copydoc Request::set_first_byte_timeout(timeout)
+		void set_first_byte_timeout(const std::optional<std::chrono::system_clock::duration>& timeout);
+
+		/// @copydoc Request::set_idle_timeout(timeout)
+		void set_idle_timeout(const std::optional<std::chrono::system_clock::duration>& timeout);
+
+		/// @copydoc Request::set_priority(priority)
+		void set_priority(const RequestPriority priority);
+
+		/// @copydoc Request::set_tenant(tenant)
+		void set_tenant(const std::string& tenant);
+
 		/// @copydoc Request::set_headers(headers)
 		void set_default_headers(const std::list<std::string>& headers);
 
@@ -38,6 +79,23 @@ namespace asyncnet {
 		/// @copydoc Request::set_cookie_file(filename)
 		void set_cookie_file(const std::string& filename);
 
+		/// @copydoc Request::set_http_version(version)
+		void set_http_version(const HttpVersion& version);
+
+		/**
+		 * Replaces session connection pool with new one with given options. Connections of the old pool are closed when its requests are done.
+		 * By default session uses pool with default @ref ConnectionPool::Options
+		 * @param options Options of the new pool
+		 */
+		void set_keep_alive(const ConnectionPool::Options& options);
+
+		/**
+		 * Replaces session concurrency limiter with new one with given options. Requests, which already wait in the old limiter, stay there.
+		 * By default session requests aren't limited
+		 * @param options Options of the new limiter
+		 */
+		void set_concurrency_limits(const ConcurrencyLimiter::Options& options);
+
 		/**
 		 * Creates request which inherits all options from AsyncSession request
 		 * @tparam T The request to create
@@ -49,7 +107,29 @@ namespace asyncnet {
 			return T(base_request_, std::forward<Args>(args) ...);
 		}
 
+		/**
+		 * Resolves and opens connections to every origin in parallel, so the first requests don't pay for DNS, TCP and TLS.
+		 * Every event loop keeps its own connections, so connections_per_origin connections are opened by every loop, or by the origin shard for @ref RequestorEngine::Sharded.
+		 * Every @ref RequestorEngine::ThreadPool worker opens one connection, since it performs one request at a time.
+		 * connections_per_origin shouldn't exceed @ref ConnectionPool::Options::max_idle_connections
+		 * @param origins Origins to connect to, like "https://example.com"
+		 * @param connections_per_origin Count of connections to open for every origin by every event loop
+		 * @return Returns awaitable task with result for every origin in the same order. Never throws on network errors, see @ref WarmUpResult::error
+		 */
+		coro::task<std::vector<WarmUpResult>> warm_up(std::vector<std::string> origins, const unsigned connections_per_origin);
+
 		using Requestor::perform_request;
+		using Requestor::perform_many;
+		using Requestor::perform_many_stream;
+		using Requestor::perform_streaming;
+		using Requestor::set_connection_pool;
+		using Requestor::get_connection_pool;
+		using Requestor::set_max_concurrent_streams;
+		using Requestor::set_concurrency_limiter;
+		using Requestor::get_concurrency_limiter;
+		using Requestor::set_max_workers;
+		using Requestor::set_tenant_weight;
+		using Requestor::set_work_stealing;
 
 	private:
 		void initialize_handle();
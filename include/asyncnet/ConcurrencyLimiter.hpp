@@ -0,0 +1,228 @@
+#pragma once
+#include <asyncnet/NetTypes.hpp>
+
+#include <array>
+#include <coroutine>
+#include <cstdint>
+#include <list>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <set>
+#include <stop_token>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace asyncnet {
+
+	/**
+	 * Limits count of requests performed at once, globally and for every origin (scheme://host:port).
+	 * Requests above the limit wait in FIFO order without occupying a worker or an event loop.
+	 * Every origin has its own queue, so requests waiting for a saturated origin don't block requests to other origins.
+	 * Free slot is given to the highest @ref RequestPriority, which has waiting requests and isn't limited by its own limit.
+	 * Inside one priority, waiting tenants take slots by deficit round robin in proportion to their weights, so a noisy tenant can't take all slots.
+	 * Tenant, which is alone, takes all free slots
+	 */
+	class ConcurrencyLimiter {
+		struct HostState;
+		struct TenantState;
+		struct Waiter;
+
+		/// Waiters of one tenant to one origin with one priority
+		struct Queue {
+			HostState* host = nullptr;
+			TenantState* tenant = nullptr;
+			size_t priority = 0;
+			std::list<Waiter*> waiters;
+			/// Sequence of the first waiter if it's in tenant ready set
+			std::optional<uint64_t> ready_sequence;
+		};
+
+		struct HostState {
+			std::string origin;
+			size_t in_flight = 0;
+			/// Queues by priority and tenant
+			std::map<std::pair<size_t, std::string>, std::unique_ptr<Queue>> queues;
+		};
+
+		struct TenantState {
+			std::string name;
+			unsigned weight = 1;
+			size_t queues_count = 0;
+			/// Queues, which have a waiter and a free origin slot, ordered by arrival for every priority
+			std::array<std::set<std::pair<uint64_t, Queue*>>, request_priority_count> ready;
+			/// Slots left in the current round robin turn for every priority
+			std::array<unsigned, request_priority_count> deficits = {};
+			/// Position in round robin of every priority, if the tenant has ready queues
+			std::array<std::optional<std::list<TenantState*>::iterator>, request_priority_count> round_positions;
+		};
+
+		struct Waiter {
+			std::coroutine_handle<> continuation = nullptr;
+			Queue* queue = nullptr;
+			HostState* host = nullptr;
+			RequestPriority priority = RequestPriority::Normal;
+			uint64_t sequence = 0;
+			std::list<Waiter*>::iterator position;
+			bool queued = false;
+			bool granted = false;
+			bool cancelled = false;
+		};
+
+	public:
+		struct Options {
+			/// Maximum count of requests performed at once. If @ref std::nullopt, there is no global limit
+			std::optional<size_t> max_in_flight = std::nullopt;
+			/// Maximum count of requests to one origin performed at once. If @ref std::nullopt, there is no per origin limit
+			std::optional<size_t> max_in_flight_per_host = std::nullopt;
+			/// Maximum count of requests of every priority performed at once, indexed by @ref RequestPriority. Caps share of lower priorities, so they can't occupy all slots
+			std::array<std::optional<size_t>, request_priority_count> max_in_flight_per_priority = {};
+			/// Weights of tenants. While slots are saturated, every waiting tenant gets share of slots proportional to its weight
+			std::unordered_map<std::string, unsigned> tenant_weights = {};
+			/// Weight of tenants, which aren't in @ref tenant_weights
+			unsigned default_tenant_weight = 1;
+		};
+
+		/**
+		 * Slot of one performed request. Passes the slot to the next waiting request when released or destroyed
+		 */
+		class Permit {
+		public:
+			Permit(const Permit& other) = delete;
+			Permit(Permit&& other) noexcept;
+			Permit& operator=(const Permit& other) = delete;
+			Permit& operator=(Permit&& other) noexcept;
+			~Permit();
+
+			/**
+			 * Frees the slot. The next waiting request is resumed on the calling thread
+			 */
+			void release() noexcept;
+
+		private:
+			friend class ConcurrencyLimiter;
+
+			explicit Permit(ConcurrencyLimiter* limiter, HostState* host, const RequestPriority priority) noexcept;
+
+			ConcurrencyLimiter* limiter_;
+			HostState* host_;
+			RequestPriority priority_;
+		};
+
+		class AcquireAwaitable {
+		public:
+			explicit AcquireAwaitable(ConcurrencyLimiter& limiter, std::string_view origin, const RequestPriority priority, std::string_view tenant, std::stop_token stop_token);
+
+			// limiter and stop callback keep pointer to the waiter
+			AcquireAwaitable(const AcquireAwaitable& other) = delete;
+			AcquireAwaitable(AcquireAwaitable&& other) = delete;
+
+			bool await_ready() const noexcept;
+
+			bool await_suspend(std::coroutine_handle<> coroutine);
+
+			/**
+			 * @return Returns permit, or @ref std::nullopt if stop was requested before the slot was given
+			 */
+			std::optional<Permit> await_resume() noexcept;
+
+		private:
+			struct Canceller {
+				void operator()() const noexcept;
+
+				ConcurrencyLimiter* limiter;
+				Waiter* waiter;
+			};
+
+			ConcurrencyLimiter& limiter_;
+			std::string origin_;
+			std::string tenant_;
+			Waiter waiter_;
+			std::stop_token stop_token_;
+			std::optional<std::stop_callback<Canceller>> stop_callback_;
+		};
+
+		explicit ConcurrencyLimiter(const Options& options);
+		ConcurrencyLimiter(const ConcurrencyLimiter& other) = delete;
+		ConcurrencyLimiter(ConcurrencyLimiter&& other) = delete;
+		~ConcurrencyLimiter();
+
+		/**
+		 * Waits for a free slot. Waiting request is resumed on the thread, which released the slot, or at once on the thread requested stop
+		 * @param origin Origin of request URL, see @ref url_origin
+		 * @param priority Priority of request
+		 * @param tenant Tenant or flow, which the request belongs to. Empty string is the default tenant
+		 * @param stop_token Token to stop waiting
+		 * @return Returns awaitable, which results in @ref Permit or @ref std::nullopt if stopped
+		 */
+		AcquireAwaitable acquire(std::string_view origin, const RequestPriority priority = RequestPriority::Normal, std::string_view tenant = {}, std::stop_token stop_token = {});
+
+		/**
+		 * @return Returns count of requests, which hold a slot
+		 */
+		size_t in_flight() const;
+
+		/**
+		 * @param priority Priority to count
+		 * @return Returns count of requests with the priority, which hold a slot
+		 */
+		size_t in_flight(const RequestPriority priority) const;
+
+		/**
+		 * @return Returns count of requests waiting for a slot
+		 */
+		size_t queued() const;
+
+		/**
+		 * @return Returns limiter options
+		 */
+		Options options() const;
+
+		/**
+		 * Thread safe changes limit of the priority. If the limit grows, waiting requests are resumed on the calling thread
+		 * @param priority Priority to limit
+		 * @param max_in_flight Maximum count of requests with the priority performed at once or @ref std::nullopt for no limit
+		 */
+		void set_priority_limit(const RequestPriority priority, const std::optional<size_t>& max_in_flight);
+
+		/**
+		 * Thread safe changes weight of the tenant. Waiting tenant gets the new weight from its next round robin turn
+		 * @param tenant Tenant to change
+		 * @param weight New weight. Zero is treated as 1
+		 */
+		void set_tenant_weight(const std::string& tenant, const unsigned weight);
+
+	private:
+		bool try_enqueue(Waiter* waiter, std::string_view origin, std::string_view tenant);
+		void cancel(Waiter* waiter);
+		void release(HostState* host, const RequestPriority priority) noexcept;
+
+		// called with locked mutex
+		HostState& host_state(std::string_view origin);
+		Queue& queue(HostState& host, const size_t priority, std::string_view tenant);
+		unsigned tenant_weight(std::string_view tenant) const;
+		void erase_if_empty(Queue& queue);
+		void erase_if_idle(HostState& host);
+		bool has_capacity() const noexcept;
+		bool host_has_capacity(const HostState& host) const noexcept;
+		bool priority_has_capacity(const size_t priority) const noexcept;
+		void update_ready(Queue& queue);
+		void update_host_ready(HostState& host);
+		TenantState& next_tenant(const size_t priority);
+		std::vector<Waiter*> dispatch();
+
+		Options options_;
+		mutable std::mutex mutex_;
+		std::unordered_map<std::string, std::unique_ptr<HostState>> hosts_;
+		std::unordered_map<std::string, std::unique_ptr<TenantState>> tenants_;
+		/// Tenants, which have ready queues, in round robin order for every priority
+		std::array<std::list<TenantState*>, request_priority_count> rounds_;
+		std::array<size_t, request_priority_count> priority_in_flight_ = {};
+		size_t in_flight_ = 0;
+		size_t queued_ = 0;
+		uint64_t next_sequence_ = 0;
+	};
+}
@@ -0,0 +1,180 @@
+#pragma once
+#include <curl/curl.h>
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+namespace asyncnet {
+
+	/**
+	 * Keeps connections alive between requests, so the handles performed with the same origin (scheme://host:port) reuse TCP and TLS connections,
+	 * DNS entries and TLS sessions instead of making new ones. DNS entries and TLS sessions are kept in one curl share of the pool,
+	 * so every event loop and worker uses them. Connections of event loop transfers are kept in the cache of the loop multi handle.
+	 * Blocking transfers get a connection cache of the origin for every thread, since curl connection cache can't be used by several threads at once,
+	 * and a handle takes only one share, so DNS entries and TLS sessions of blocking transfers are kept in that cache too.
+	 * Per-thread caches, which weren't used for @ref Options::idle_timeout, are removed with their connections
+	 */
+	class ConnectionPool {
+		struct SharedCache;
+
+	public:
+		/**
+		 * Way the leased handle is performed
+		 */
+		enum class PerformMode {
+			/// Handle is added to a multi handle of event loop, which keeps connections in its own cache
+			MultiHandle,
+			/// Handle is performed by curl_easy_perform on the calling thread
+			Blocking
+		};
+
+		struct Options {
+			/// Maximum count of idle connections kept alive for one origin cache of blocking transfers or for one event loop
+			long max_idle_connections = 8;
+			/// Connection that was idle for longer than this is closed instead of reused
+			std::chrono::seconds idle_timeout = std::chrono::seconds(118);
+			/// Connection that is older than this is not reused. If @ref std::nullopt, connection can live infinitely long
+			std::optional<std::chrono::seconds> max_connection_age = std::nullopt;
+			/// Share resolved host names between requests
+			bool share_dns = true;
+			/// Share TLS session ids between requests, so new connections can resume the TLS session
+			bool share_tls_sessions = true;
+		};
+
+		/**
+		 * Cache hit/miss counters. Only successful transfers are counted
+		 */
+		struct Statistics {
+			/// Transfers, which reused an alive connection
+			uint64_t connection_hits = 0;
+			/// Transfers, which made a new connection
+			uint64_t connection_misses = 0;
+			/// New connections, which took the host address from DNS cache
+			uint64_t dns_hits = 0;
+			/// New connections, which resolved the host name
+			uint64_t dns_misses = 0;
+			/// New TLS connections, which resumed a TLS session. Resumption is reported only by OpenSSL backend of curl, connections of other backends aren't counted
+			uint64_t tls_session_cache_hits = 0;
+			/// New TLS connections, which made a full handshake. Counted only with OpenSSL backend of curl
+			uint64_t tls_session_cache_misses = 0;
+		};
+
+		/**
+		 * Attachment of one handle to the pool caches. Detaches the handle when released or destroyed
+		 */
+		class Lease {
+		public:
+			/**
+			 * Attaches the pool caches to the handle. Blocking handle must be performed on the thread, which creates the lease
+			 * @param pool The pool to attach from. Must outlive the lease
+			 * @param easy The handle to attach
+			 * @param origin Origin of handle URL, see @ref url_origin
+			 * @param mode Way the handle is performed
+			 */
+			explicit Lease(ConnectionPool& pool, CURL* easy, std::string_view origin, const PerformMode mode);
+
+			// curl keeps pointer to the lease while transfer is performed
+			Lease(const Lease& other) = delete;
+			Lease(Lease&& other) = delete;
+			~Lease();
+
+			/**
+			 * Detaches the handle. The connection stays in the cache and can be reused by the next handle
+			 * @param record_statistics Set to true to count performed transfer in @ref ConnectionPool::statistics
+			 */
+			void release(const bool record_statistics) noexcept;
+
+		private:
+			static int resolver_start_callback(void* resolver_state, void* reserved, void* userdata);
+			static int prereq_callback(void* userdata, char* primary_ip, char* local_ip, int primary_port, int local_port);
+
+			ConnectionPool* pool_;
+			CURL* easy_;
+			SharedCache* cache_;
+			bool resolver_started_ = false;
+			/// Set when connection is ready, if TLS backend reports session resumption
+			std::optional<bool> tls_session_reused_;
+		};
+
+		explicit ConnectionPool();
+		explicit ConnectionPool(const Options& options);
+		ConnectionPool(const ConnectionPool& other) = delete;
+		ConnectionPool(ConnectionPool&& other) = delete;
+		~ConnectionPool();
+
+		/**
+		 * @return Returns count of origin caches of blocking transfers of every thread
+		 */
+		size_t origins_count() const;
+
+		/**
+		 * @return Returns pool options
+		 */
+		const Options& options() const noexcept;
+
+		/**
+		 * @return Returns snapshot of cache counters
+		 */
+		Statistics statistics() const noexcept;
+
+	private:
+		struct SharedCache {
+			/**
+			 * @param options Options of the pool, which tell what data is shared
+			 * @param share_connections Set to true to share connection cache too
+			 */
+			explicit SharedCache(const Options& options, const bool share_connections);
+			~SharedCache();
+
+			CURLSH* share;
+			std::array<std::mutex, CURL_LOCK_DATA_LAST> mutexes;
+			/// Count of attached handles of per-thread cache, guarded by pool mutex
+			size_t leases = 0;
+			/// Time of the last detach, guarded by pool mutex
+			std::chrono::steady_clock::time_point last_used;
+		};
+
+		struct OriginKey {
+			std::string origin;
+			const void* owner;
+
+			bool operator==(const OriginKey& other) const = default;
+		};
+
+		struct OriginKeyHash {
+			size_t operator()(const OriginKey& key) const noexcept;
+		};
+
+		static void lock_callback(CURL* easy, curl_lock_data data, curl_lock_access access, void* userptr);
+		static void unlock_callback(CURL* easy, curl_lock_data data, void* userptr);
+
+		static const void* current_thread_owner() noexcept;
+
+		SharedCache* attach(std::string_view origin, const PerformMode mode);
+		void detach(SharedCache* cache) noexcept;
+		void evict_idle(std::chrono::steady_clock::time_point now);
+
+		Options options_;
+		/// DNS entries and TLS sessions of event loop transfers, or nullptr if nothing is shared
+		std::unique_ptr<SharedCache> session_cache_;
+		mutable std::mutex mutex_;
+		/// Caches of blocking transfers by origin and thread
+		std::unordered_map<OriginKey, std::unique_ptr<SharedCache>, OriginKeyHash> origins_;
+		std::chrono::steady_clock::time_point next_eviction_;
+
+		std::atomic<uint64_t> connection_hits_ = 0;
+		std::atomic<uint64_t> connection_misses_ = 0;
+		std::atomic<uint64_t> dns_hits_ = 0;
+		std::atomic<uint64_t> dns_misses_ = 0;
+		std::atomic<uint64_t> tls_session_cache_hits_ = 0;
+		std::atomic<uint64_t> tls_session_cache_misses_ = 0;
+	};
+}
@@ -5,11 +5,32 @@
 
 namespace asyncnet {
 
-	/// Code for timeout runtime error
+	/// Code for timeout runtime error. Expired timeouts raise @ref TimeoutError, which tells the timeout
 	constexpr CURLcode TimeoutErrorCode = CURLE_OPERATION_TIMEDOUT;
 	/// Code for cancelled runtime error
 	constexpr CURLcode CancelledErrorCode = CURLE_ABORTED_BY_CALLBACK;
 
+	/**
+	 * Timeout, which expired
+	 */
+	enum class TimeoutKind {
+		/// Timeout of the whole request, see @ref Request::set_timeout
+		Request,
+		/// Connection, including TLS handshake, wasn't established in time, see @ref Request::set_connect_timeout
+		Connect,
+		/// Server didn't start to respond in time, see @ref Request::set_first_byte_timeout
+		FirstByte,
+		/// Nothing was sent or received for too long, see @ref Request::set_idle_timeout
+		Idle
+	};
+
+	/**
+	 * Get human readable description of expired timeout
+	 * @param kind The timeout to describe
+	 * @return Returns error description
+	 */
+	extern const char* error_string(const TimeoutKind kind) noexcept;
+
 	/**
 	 * Call @ref whatCode() to get error code
 	 */
@@ -19,4 +40,23 @@ namespace asyncnet {
 	 * Call @ref whatCode() to get error code
 	 */
 	using NetworkRuntimeError = curlpp::LibcurlRuntimeError;
-};
\ No newline at end of file
+
+	/**
+	 * Runtime error of expired timeout. @ref whatCode() is @ref TimeoutErrorCode, call @ref kind() to get which timeout expired
+	 */
+	class TimeoutError : public NetworkRuntimeError {
+	public:
+		/**
+		 * @param kind The timeout, which expired
+		 */
+		explicit TimeoutError(const TimeoutKind kind);
+
+		/**
+		 * @return Returns the timeout, which expired
+		 */
+		TimeoutKind kind() const noexcept;
+
+	private:
+		TimeoutKind kind_;
+	};
+};
@@ -0,0 +1,72 @@
+#pragma once
+#include <asyncnet/NetTypes.hpp>
+
+#include <coro/task.hpp>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <string>
+
+#pragma warning(push, 0)
+#include <boost/json.hpp>
+#pragma warning(pop)
+
+namespace asyncnet {
+
+	/**
+	 * Producer of request body, which serializes JSON by chunks while the body is sent, see @ref StreamingPostRequest.
+	 * Serialized text is never kept as a whole: every call serializes only the next chunk, and the upload buffer waits for the transfer when it's full.
+	 * Since Boost 1.86 types supported by @ref detail::parse_into_supported are serialized directly, other types are converted with @ref boost::json::value_from into DOM first.
+	 * Copies made before the first call start from the first chunk, so the request can be performed again
+	 */
+	class JsonBodySource {
+	public:
+		/// Default size of serialized chunk
+		static constexpr size_t default_chunk_size = 64 * 1024;
+
+		/**
+		 * @tparam T The type of body, which is serialized to JSON
+		 * @param body The body to serialize. It's shared by copies of the source, so it must not be changed until the body is sent
+		 * @param chunk_size Size of serialized chunk
+		 */
+		template<typename T>
+		explicit JsonBodySource(std::shared_ptr<const T> body, const size_t chunk_size = default_chunk_size) :
+			reset_([body = std::move(body)](boost::json::serializer& serializer, std::optional<boost::json::value>& document) {
+				if constexpr (std::same_as<T, boost::json::value>) {
+					serializer.reset(body.get());
+				}
+#if BOOST_VERSION >= 108600
+				else if constexpr (detail::parse_into_supported<T>) {
+					serializer.reset(body.get());
+				}
+#endif
+				else {
+					// nodes of the document are freed at once with the source
+					document.emplace(boost::json::value_from(*body, boost::json::make_shared_resource<boost::json::monotonic_resource>()));
+					serializer.reset(&*document);
+				}
+			}),
+			chunk_size_(chunk_size)
+		{
+
+		}
+
+		/**
+		 * Serializes the next chunk
+		 * @return Returns awaitable task with the next chunk, or @ref std::nullopt when the body is over
+		 */
+		coro::task<std::optional<std::string>> operator()();
+
+	private:
+		struct State {
+			boost::json::serializer serializer;
+			/// Document converted from the body, if it isn't serialized directly
+			std::optional<boost::json::value> document;
+		};
+
+		std::function<void(boost::json::serializer&, std::optional<boost::json::value>&)> reset_;
+		size_t chunk_size_;
+		/// Made by the first call, so copies made before it are independent
+		std::shared_ptr<State> state_;
+	};
+}
@@ -0,0 +1,68 @@
+#pragma once
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#pragma warning(push, 0)
+#include <boost/json.hpp>
+#pragma warning(pop)
+
+namespace asyncnet {
+
+	/**
+	 * Extracts values at JSON Pointers from JSON text without building DOM of the whole text.
+	 * Text is parsed by SAX parser, which may be fed by chunks, like ones of @ref StreamingResponse::next_chunk.
+	 * Only matched values are allocated, parsing stops as soon as every value is found, so the rest of text isn't validated
+	 */
+	class JsonFieldExtractor {
+	public:
+		/**
+		 * @param pointers JSON Pointers of values to extract, like "/data/0/id". Empty pointer extracts the whole text
+		 * @param storage Storage of extracted values
+		 * @throws std::invalid_argument If pointer is invalid
+		 */
+		explicit JsonFieldExtractor(const std::vector<std::string>& pointers, boost::json::storage_ptr storage = {});
+		JsonFieldExtractor(const JsonFieldExtractor& other) = delete;
+		JsonFieldExtractor(JsonFieldExtractor&& other) noexcept;
+		JsonFieldExtractor& operator=(const JsonFieldExtractor& other) = delete;
+		JsonFieldExtractor& operator=(JsonFieldExtractor&& other) noexcept;
+		~JsonFieldExtractor();
+
+		/**
+		 * Parses the next chunk of text. Chunks after every value is found are skipped
+		 * @param chunk Part of JSON text
+		 * @throws boost::system::system_error If text is invalid
+		 */
+		void write(std::string_view chunk);
+
+		/**
+		 * @return Returns true if every value is found, so the rest of text isn't needed
+		 */
+		bool done() const noexcept;
+
+		/**
+		 * Ends the text
+		 * @return Returns value for every pointer in the same order or @ref std::nullopt if text has no such value
+		 * @throws boost::system::system_error If text is invalid or incomplete
+		 */
+		std::vector<std::optional<boost::json::value>> finish();
+
+	private:
+		class Parser;
+
+		std::unique_ptr<Parser> parser_;
+	};
+
+	/**
+	 * Extracts values at JSON Pointers from JSON text, see @ref JsonFieldExtractor
+	 * @param from The text to extract from
+	 * @param pointers JSON Pointers of values to extract
+	 * @param storage Storage of extracted values
+	 * @return Returns value for every pointer in the same order or @ref std::nullopt if text has no such value
+	 * @throws std::invalid_argument If pointer is invalid
+	 * @throws boost::system::system_error If text is invalid
+	 */
+	extern std::vector<std::optional<boost::json::value>> extract_json_fields(std::string_view from, const std::vector<std::string>& pointers, boost::json::storage_ptr storage = {});
+}
@@ -0,0 +1,61 @@
+#pragma once
+#if ASYNCNET_USE_SIMDJSON
+#include <asyncnet/Response.hpp>
+
+#include <memory>
+#include <string_view>
+
+#pragma warning(push, 0)
+#include <boost/json.hpp>
+#include <simdjson.h>
+#pragma warning(pop)
+
+namespace asyncnet {
+
+	/**
+	 * Read-only JSON document parsed by simdjson On-Demand, which is several times faster than DOM parsing for big documents.
+	 * Values are parsed lazily while they are accessed in document order, see simdjson On-Demand documentation
+	 */
+	class JsonView {
+	public:
+		/**
+		 * Views response body without copying, if it's padded, see @ref ResponseBody::padded_view. Response must outlive the view
+		 * @param response Response with JSON body
+		 * @throws simdjson::simdjson_error If body can't be parsed
+		 */
+		explicit JsonView(const Response& response);
+
+		/**
+		 * Copies JSON into padded buffer and views it
+		 * @param json JSON text
+		 * @throws simdjson::simdjson_error If text can't be parsed
+		 */
+		explicit JsonView(std::string_view json);
+
+		JsonView(const JsonView& other) = delete;
+		JsonView(JsonView&& other) noexcept = default;
+		JsonView& operator=(const JsonView& other) = delete;
+		JsonView& operator=(JsonView&& other) noexcept = default;
+
+		/**
+		 * @return Returns On-Demand document to read values from
+		 */
+		simdjson::ondemand::document& document() noexcept;
+
+		/**
+		 * Converts the whole document into @ref boost::json::value for code, which needs DOM. Document is rewound before and after conversion
+		 * @param storage Storage of the converted value
+		 * @return Returns converted value
+		 * @throws simdjson::simdjson_error If document is invalid
+		 */
+		boost::json::value to_value(boost::json::storage_ptr storage = {});
+
+	private:
+		/// Owns text, which isn't padded
+		simdjson::padded_string text_;
+		/// Document references the parser, so the parser isn't moved with the view
+		std::unique_ptr<simdjson::ondemand::parser> parser_;
+		simdjson::ondemand::document document_;
+	};
+}
+#endif
@@ -0,0 +1,109 @@
+#pragma once
+#include <asyncnet/StreamingResponse.hpp>
+
+#include <coro/task.hpp>
+#include <memory>
+#include <optional>
+#include <string>
+
+#pragma warning(push, 0)
+#include <boost/json.hpp>
+#pragma warning(pop)
+
+namespace asyncnet {
+
+	/**
+	 * Splits newline delimited JSON (NDJSON, JSON Lines) into records. Record parts are fed to incremental parser straight from chunks,
+	 * so record split by chunk boundary isn't copied. Empty lines are skipped
+	 */
+	class NdjsonDecoder {
+	public:
+		/**
+		 * @param storage Storage of parsed records
+		 */
+		explicit NdjsonDecoder(boost::json::storage_ptr storage = {});
+
+		/**
+		 * Adds the next chunk. Records of the previous chunk must be taken by @ref next before
+		 * @param chunk Part of text
+		 */
+		void feed(std::string chunk);
+
+		/**
+		 * Takes the next record, which is ended in fed chunks
+		 * @return Returns the record or @ref std::nullopt if the next chunk is needed
+		 * @throws boost::system::system_error If the record is invalid. The rest of its line is skipped, so decoding continues from the next record
+		 */
+		std::optional<boost::json::value> next();
+
+		/**
+		 * Ends the text
+		 * @return Returns the last record, which isn't ended by newline, or @ref std::nullopt if there is no such record
+		 * @throws boost::system::system_error If the record is invalid
+		 */
+		std::optional<boost::json::value> finish();
+
+	private:
+		void reset() noexcept;
+
+		boost::json::storage_ptr storage_;
+		/// Held by pointer, because the parser isn't movable
+		std::unique_ptr<boost::json::stream_parser> parser_;
+		std::string chunk_;
+		size_t offset_ = 0;
+		/// Some of current record is fed to the parser
+		bool has_record_ = false;
+		/// Rest of invalid record is skipped until newline
+		bool is_skipping_ = false;
+	};
+
+	/**
+	 * Response, which body is newline delimited JSON read by records while the transfer is running, see @ref Requestor::perform_streaming.
+	 * Every record is available as soon as its line is received
+	 */
+	class NdjsonStream {
+	public:
+		/**
+		 * @param response Streaming response with NDJSON body
+		 * @param storage Storage of parsed records
+		 */
+		explicit NdjsonStream(StreamingResponse&& response, boost::json::storage_ptr storage = {});
+
+		/**
+		 * Waits for the next record. Reader is switched to executor pool of the requestor like after @ref StreamingResponse::next_chunk
+		 * @return Returns awaitable task with the record or @ref std::nullopt, when the body is over
+		 * @throws boost::system::system_error If the record is invalid. The next call continues from the next record
+		 * @throws NetworkRuntimeError If transfer failed, after every received record was read
+		 */
+		coro::task<std::optional<boost::json::value>> next();
+
+		/**
+		 * Waits for the next record and converts it with @ref boost::json::value_to
+		 * @tparam T The type to convert into
+		 * @return Returns awaitable task with the record or @ref std::nullopt, when the body is over
+		 */
+		template<typename T>
+		coro::task<std::optional<T>> next_as() {
+			auto record = co_await next();
+			if (!record) {
+				co_return std::nullopt;
+			}
+			co_return boost::json::value_to<T>(*record);
+		}
+
+		/**
+		 * Get HTTP status code
+		 * @return HTTP status code, which is known after the first chunk or the end of body, otherwise 0
+		 */
+		long get_status_code() const;
+
+		/**
+		 * Thread safe cancels the transfer, see @ref StreamingResponse::request_stop
+		 */
+		void request_stop() noexcept;
+
+	private:
+		StreamingResponse response_;
+		NdjsonDecoder decoder_;
+	};
+}
@@ -1,9 +1,14 @@
 #pragma once
+#include <asyncnet/detail/JsonParse.hpp>
+
 #include <string>
 #include <vector>
 #include <exception>
+#include <functional>
+#include <optional>
 #include <string_view>
 #include <curlpp/Form.hpp>
+#include <coro/task.hpp>
 
 #pragma warning(push, 0)
 #include <boost/json.hpp>
@@ -11,6 +16,21 @@
 
 namespace asyncnet {
 
+	/**
+	 * Priority class of request. Higher class waiting for a slot always goes before lower ones
+	 */
+	enum class RequestPriority {
+		/// Latency critical requests, like user facing calls
+		Interactive,
+		/// Default priority
+		Normal,
+		/// Background requests, like backfills, which can wait
+		Bulk
+	};
+
+	/// Count of @ref RequestPriority classes
+	constexpr size_t request_priority_count = 3;
+
 	class UrlParameters {
 	public:
 
@@ -75,6 +95,23 @@ namespace asyncnet {
 	 */
 	extern std::string url_escape(std::string_view str);
 
+	/**
+	 * Get origin of the url as lowercase "scheme://host[:port]". User info, path, query and fragment are dropped.
+	 * If url has no scheme, "http" is used
+	 * @param url The url to get origin from
+	 * @return Returns url origin
+	 */
+	extern std::string url_origin(std::string_view url);
+
+	/**
+	 * Parse string as JSON with parser, which is reused by every call on the thread, so its temporary buffers aren't allocated again
+	 * @param from The string to parse
+	 * @param storage Storage of the parsed value, like @ref boost::json::monotonic_resource for bump-pointer allocation and single free per document
+	 * @return Returns parsed value
+	 * @throws @ref boost::system::system_error If parse failed
+	 */
+	extern boost::json::value parse_json(std::string_view from, boost::json::storage_ptr storage = {});
+
 	/**
 	 * Parse string as @ref boost::json::object
 	 * @param from The string to parse
@@ -83,10 +120,98 @@ namespace asyncnet {
 	 */
 	extern boost::json::object parse_json_object(std::string_view from);
 
+	namespace detail {
+		/**
+		 * Parse string into DOM and convert it with @ref boost::json::value_to.
+		 * Temporary DOM is allocated from arena only if T keeps no JSON containers, see @ref json_storage_free
+		 * @tparam T The type to convert into
+		 * @param from The string to parse
+		 * @return Returns converted value
+		 * @throws @ref boost::system::system_error If parse or conversion failed
+		 */
+		template<typename T>
+		T parse_json_dom_as(std::string_view from) {
+			if constexpr (json_storage_free<T>) {
+				// temporary document is freed at once after conversion
+				boost::json::monotonic_resource arena;
+				return boost::json::value_to<T>(parse_json(from, &arena));
+			}
+			else {
+				// JSON containers in the result share storage of the document, so it must outlive the call
+				return boost::json::value_to<T>(parse_json(from));
+			}
+		}
+	}
+
+	/**
+	 * Parse string into T. Types supported by @ref detail::parse_into_supported, like described structs of numbers, strings and vectors,
+	 * are filled in one pass of SAX parser without building DOM, values of unknown object keys are skipped by the same pass.
+	 * Other types, like ones with @ref json::timestamp or own tag_invoke conversions, are parsed into DOM and converted with @ref boost::json::value_to.
+	 * Both ways give the same result, unknown object keys are ignored
+	 * @tparam T The type to parse into
+	 * @param from The string to parse
+	 * @return Returns parsed value
+	 * @throws @ref boost::system::system_error If parse failed
+	 */
+	template<typename T>
+	T parse_json_as(std::string_view from) {
+		if constexpr (detail::parse_into_supported<T>) {
+			T result{};
+			detail::parse_json_into(from, &result, detail::json_into_ops<T>);
+			return result;
+		}
+		else {
+			return detail::parse_json_dom_as<T>(from);
+		}
+	}
+
+	namespace detail {
+		/**
+		 * Reads the whole output of serializer, which is reset to a value
+		 * @param serializer The serializer to read
+		 * @return Returns serialized text
+		 */
+		extern std::string read_serializer(boost::json::serializer& serializer);
+	}
+
+	/**
+	 * Serialize T into JSON text. Since Boost 1.86 types supported by @ref detail::parse_into_supported, like described structs, are serialized directly without building DOM.
+	 * Other types, like ones with @ref json::timestamp conversions, are converted with @ref boost::json::value_from into temporary DOM
+	 * @tparam T The type to serialize
+	 * @param from The value to serialize
+	 * @return Returns serialized text
+	 */
+	template<typename T>
+	std::string serialize_json(const T& from) {
+		boost::json::serializer serializer;
+		if constexpr (std::same_as<T, boost::json::value>) {
+			serializer.reset(&from);
+			return detail::read_serializer(serializer);
+		}
+#if BOOST_VERSION >= 108600
+		else if constexpr (detail::parse_into_supported<T>) {
+			serializer.reset(&from);
+			return detail::read_serializer(serializer);
+		}
+#endif
+		else {
+			// temporary document is freed at once after serialization
+			boost::json::monotonic_resource arena;
+			const boost::json::value value = boost::json::value_from(from, &arena);
+			serializer.reset(&value);
+			return detail::read_serializer(serializer);
+		}
+	}
+
 	using MultipartPart = utilspp::clone_ptr<curlpp::FormPart>;
 	using MultipartFilePart = curlpp::FormParts::File;
 	using MultipartContentPart = curlpp::FormParts::Content;
 
 	using MultipartForms = curlpp::Forms;
+
+	/**
+	 * Producer of request body, which is sent while it's produced. Every call returns awaitable task with the next body chunk, or @ref std::nullopt when the body is over
+	 */
+	using BodySource = std::function<coro::task<std::optional<std::string>>()>;
 };
 
@@ -81,6 +81,8 @@ namespace asyncnet {
 
 			bool request_stop() noexcept;
 
+			std::stop_source get_stop_source() const noexcept;
+
 		protected:
 			std::coroutine_handle<> continuation_ = nullptr;
 
@@ -148,6 +150,11 @@ namespace asyncnet {
 		 */
 		bool request_stop() noexcept;
 
+		/**
+		 * @return Returns source, which stops the coroutine. Unlike the task, it can be kept after the task is destroyed
+		 */
+		std::stop_source get_stop_source() const noexcept;
+
 	private:
 		coroutine_handle coroutine_ = nullptr;
 	};
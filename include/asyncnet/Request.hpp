@@ -3,13 +3,60 @@
 #include <asyncnet/NetTypes.hpp>
 
 #include <curlpp/Easy.hpp>
+#include <algorithm>
+#include <chrono>
 #include <list>
+#include <memory>
 #include <stop_token>
 #include <optional>
 #include <sstream>
 
 namespace asyncnet {
 
+	/**
+	 * HTTP protocol version used by request
+	 */
+	enum class HttpVersion {
+		/// Let curl decide
+		Default,
+		/// HTTP/1.1 only
+		Http1_1,
+		/// HTTP/2 for HTTPS (negotiated with ALPN), HTTP/1.1 for HTTP
+		Http2,
+		/// HTTP/2 without upgrade for both HTTP (h2c) and HTTPS. Use only if server is known to support it
+		Http2PriorKnowledge
+	};
+
+	/**
+	 * How @ref Requestor keeps response body
+	 */
+	enum class ResponseBodyMode {
+		/// Body is kept as text, see @ref Response::get_text
+		Text,
+		/// Body is parsed as JSON while it's received and isn't kept, see @ref Response::get_json. Body of other Content-Type is kept as text
+		Json
+	};
+
+	/**
+	 * Request options, which are applied by @ref Requestor rather than by curl
+	 */
+	struct PerformOptions {
+		/// Maximum time until the first response byte, see @ref Request::set_first_byte_timeout
+		std::optional<std::chrono::milliseconds> first_byte_timeout;
+		/// Maximum time without any transfer progress, see @ref Request::set_idle_timeout
+		std::optional<std::chrono::milliseconds> idle_timeout;
+		/// Priority of waiting for a worker or a concurrency slot, see @ref Request::set_priority
+		RequestPriority priority = RequestPriority::Normal;
+		/// Tenant to share workers and concurrency slots fairly, see @ref Request::set_tenant
+		std::string tenant;
+		/// Producer of request body sent while it's produced, see @ref StreamingPostRequest
+		BodySource body_source;
+		/// How response body is kept, see @ref Request::set_body_mode
+		ResponseBodyMode body_mode = ResponseBodyMode::Text;
+		/// Storage of JSON response document, see @ref Request::set_json_storage
+		std::optional<boost::json::storage_ptr> json_storage;
+	};
+
 	class Request {
 	public:
 #if defined(_WIN32)
@@ -50,6 +97,13 @@ namespace asyncnet {
 		 */
 		curlpp::Easy make_request_handle() const;
 
+		/**
+		 * Get options, which must be passed to @ref Requestor::perform_handle with handle from @ref make_request_handle.
+		 * @ref Requestor::perform_request passes them automatically
+		 * @return Request perform options
+		 */
+		const PerformOptions& get_perform_options() const noexcept;
+
 		/**
 		 * Set request new url. Note that it will clear all UrlParameters setted before!
 		 * @param url The url to set
@@ -65,13 +119,69 @@ namespace asyncnet {
 		void set_max_redirects(const std::optional<long>& max_redirects);
 
 		/**
-		 * Set timeout for the request, the request will raise exception if timeout exceeds.
+		 * Set timeout for the whole request, the request will raise @ref TimeoutError with @ref TimeoutKind::Request if timeout exceeds.
+		 * Timeout has millisecond precision, shorter non-zero timeout is rounded up to 1 millisecond.
 		 * If passed @ref std::nullopt, it means no timeout, the request can wait infinitely long.
 		 * By default setted to @ref std::nullopt
 		 * @param timeout Timeout or @ref std::nullopt
 		 */
 		void set_timeout(const std::optional<std::chrono::system_clock::duration>& timeout);
 
+		/**
+		 * Set timeout for establishing connection, including TLS handshake. The request will raise @ref TimeoutError with @ref TimeoutKind::Connect if it expires before the whole request timeout.
+		 * If passed @ref std::nullopt, curl default 300 seconds is used.
+		 * By default setted to @ref std::nullopt
+		 * @param timeout Timeout or @ref std::nullopt
+		 */
+		void set_connect_timeout(const std::optional<std::chrono::system_clock::duration>& timeout);
+
+		/**
+		 * Set timeout until the first response byte is received, counting from the request start.
+		 * The request will raise @ref TimeoutError with @ref TimeoutKind::FirstByte if timeout exceeds.
+		 * Has millisecond precision for @ref RequestorEngine::EventLoop, and about one second precision for @ref RequestorEngine::ThreadPool.
+		 * If passed @ref std::nullopt, it means no timeout. By default setted to @ref std::nullopt
+		 * @param timeout Timeout or @ref std::nullopt
+		 */
+		void set_first_byte_timeout(const std::optional<std::chrono::system_clock::duration>& timeout);
+
+		/**
+		 * Set timeout for the time, when nothing is sent or received. The request will raise @ref TimeoutError with @ref TimeoutKind::Idle if timeout exceeds.
+		 * Has half of timeout precision for @ref RequestorEngine::EventLoop, and about one second precision for @ref RequestorEngine::ThreadPool.
+		 * If passed @ref std::nullopt, it means no timeout. By default setted to @ref std::nullopt
+		 * @param timeout Timeout or @ref std::nullopt
+		 */
+		void set_idle_timeout(const std::optional<std::chrono::system_clock::duration>& timeout);
+
+		/**
+		 * Set priority class of the request. Requests of higher class, which wait for a worker or @ref ConcurrencyLimiter slot, always go first.
+		 * By default setted to @ref RequestPriority::Normal
+		 * @param priority Priority of request
+		 */
+		void set_priority(const RequestPriority priority);
+
+		/**
+		 * Set tenant or flow, which the request belongs to. Waiting tenants take workers and @ref ConcurrencyLimiter slots in turn by their weights,
+		 * see @ref Requestor::set_tenant_weight. By default setted to empty string, which is the default tenant
+		 * @param tenant Tenant key
+		 */
+		void set_tenant(const std::string& tenant);
+
+		/**
+		 * Set how response body is kept. With @ref ResponseBodyMode::Json every received chunk is fed to the parser on the transfer thread,
+		 * so parsing overlaps the transfer. Body of other Content-Type, like HTML error page, is kept as text,
+		 * and invalid JSON is reported by @ref Response::get_json_error without failing the request.
+		 * By default setted to @ref ResponseBodyMode::Text
+		 * @param mode Mode of response body
+		 */
+		void set_body_mode(const ResponseBodyMode mode);
+
+		/**
+		 * Set storage of document parsed with @ref ResponseBodyMode::Json. By default every document gets own @ref boost::json::monotonic_resource,
+		 * so its nodes are bump-pointer allocated and freed at once with the document
+		 * @param storage Storage to allocate document from or @ref std::nullopt for the default
+		 */
+		void set_json_storage(const std::optional<boost::json::storage_ptr>& storage);
+
 		/**
 		 * Set the reques verbosity. If setted to true, debug information will be printed to stdout.
 		 * By default setted to false
@@ -105,6 +215,21 @@ namespace asyncnet {
 		void set_cookie_file(const std::string& cookie_file);
 		void set_cookie_file(std::string_view cookie_file);
 
+		/**
+		 * Set HTTP protocol version. For HTTP/2 versions the request waits for the connection to the same origin to multiplex on,
+		 * instead of making a new one. Multiplexing works only with @ref RequestorEngine::EventLoop.
+		 * By default setted to @ref HttpVersion::Default
+		 * @param version HTTP version
+		 */
+		void set_http_version(const HttpVersion& version);
+
+		/**
+		 * Set how request body waits for "100 Continue" response. Curl asks for it before large or streaming bodies and waits 1 second by default.
+		 * If passed @ref std::nullopt, "Expect" header isn't sent and body is sent at once. Disabling adds "Expect:" header, so call it after @ref set_headers
+		 * @param timeout Maximum time to wait for "100 Continue" or @ref std::nullopt to disable waiting
+		 */
+		void set_expect_continue(const std::optional<std::chrono::system_clock::duration>& timeout);
+
 
 	protected:
 
@@ -117,16 +242,20 @@ namespace asyncnet {
 		void set_option(OptionArg&& arg) {
 			if (Option* vec_option = get_option<Option>()) {
 				vec_option->setValue(std::forward<OptionArg>(arg));
+				return;
 			}
-			else {
-				options_.push_back(std::make_unique<Option>(std::forward<OptionArg>(arg)));
-			}
+
+			// the same curl option of another type, like shared and copied post fields, is replaced
+			std::erase_if(options_, [](const std::unique_ptr<curlpp::OptionBase>& vec_option) {
+				return Option::option == vec_option->getOption();
+			});
+			options_.push_back(std::make_unique<Option>(std::forward<OptionArg>(arg)));
 		}
 
 		/**
 		 * Get request option.
 		 * @tparam Option type to be getted
-		 * @return If Request contains Option, return pointer to it. Otherwise, return nullptr
+		 * @return If Request contains Option, return pointer to it. Otherwise, or if the curl option has another type, return nullptr
 		 */
 		template<typename Option>
 		Option* get_option() {
@@ -134,11 +263,12 @@ namespace asyncnet {
 				return Option::option == vec_option->getOption();
 			});
 
-			return iter != options_.end() ? static_cast<Option*>(iter->get()) : nullptr;
+			return iter != options_.end() ? dynamic_cast<Option*>(iter->get()) : nullptr;
 		}
 
 		std::vector<std::unique_ptr<curlpp::OptionBase>> options_;
 		std::string base_url_;
+		PerformOptions perform_options_;
 	};
 
 	class PostRequest : public Request {
@@ -162,6 +292,61 @@ namespace asyncnet {
 
 	};
 
+	class JsonPostRequest : public Request {
+	public:
+		/** @copydoc Request::Request(url)
+		 * Constructs POST request with body serialized from T by @ref serialize_json, and "Content-Type: application/json" header.
+		 * The body is serialized once and shared by copies of the request and its handles, so neither the request nor curl copies it
+		 * @tparam T The type of body, which is serialized to JSON
+		 * @param url Request URL
+		 * @param body Request body
+		 */
+		template<typename T>
+		explicit JsonPostRequest(std::string_view url, const T& body) : Request(url) {
+			set_body(serialize_json(body));
+		}
+
+		/** @copydoc Request::Request(copy_request, url)
+		 * Constructs POST request with body serialized from T. Content type of copy_request is replaced
+		 * @tparam T The type of body, which is serialized to JSON
+		 * @param copy_request Request to copy options from
+		 * @param url Request URL
+		 * @param body Request body
+		 */
+		template<typename T>
+		explicit JsonPostRequest(const Request& copy_request, std::string_view url, const T& body) : Request(copy_request, url) {
+			set_body(serialize_json(body));
+		}
+
+	private:
+		void set_body(std::string body);
+	};
+
+	class StreamingPostRequest : public Request {
+	public:
+		/** @copydoc Request::Request(url)
+		 * Constructs POST request, which body is sent while it's produced, so the body is never kept in memory as a whole.
+		 * If body length is unknown, HTTP/1.1 request is sent with chunked transfer encoding.
+		 * The source is called from the first chunk every time the request is performed
+		 * @param url Request URL
+		 * @param source Producer of body chunks
+		 * @param content_length Length of the whole body or @ref std::nullopt if unknown
+		 */
+		explicit StreamingPostRequest(std::string_view url, BodySource source, const std::optional<curl_off_t>& content_length = std::nullopt);
+
+		/** @copydoc Request::Request(copy_request, url)
+		 * Constructs POST request, which body is sent while it's produced
+		 * @param copy_request Request to copy options from
+		 * @param url Request URL
+		 * @param source Producer of body chunks
+		 * @param content_length Length of the whole body or @ref std::nullopt if unknown
+		 */
+		explicit StreamingPostRequest(const Request& copy_request, std::string_view url, BodySource source, const std::optional<curl_off_t>& content_length = std::nullopt);
+
+	private:
+		void set_source(BodySource source, const std::optional<curl_off_t>& content_length);
+	};
+
 	using GetRequest = Request;
 
 	class HeadRequest : public Request {
@@ -213,4 +398,15 @@ namespace asyncnet {
 		 */
 		void add_form(const MultipartPart& part);
 	};
+
+	class WarmUpRequest : public Request {
+	public:
+		/** @copydoc Request::Request(copy_request, url)
+		 * Constructs request, which opens new connection to the origin and sends "OPTIONS *" over it.
+		 * Connection stays in the connection pool and can be reused by the next requests
+		 * @param copy_request Request to copy options from
+		 * @param origin Origin to connect to, like "https://example.com"
+		 */
+		WarmUpRequest(const Request& copy_request, std::string_view origin);
+	};
 };
\ No newline at end of file
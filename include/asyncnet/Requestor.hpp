@@ -1,29 +1,65 @@
 #pragma once
+#include <asyncnet/ConcurrencyLimiter.hpp>
+#include <asyncnet/ConnectionPool.hpp>
 #include <asyncnet/Exceptions.hpp>
 #include <asyncnet/Request.hpp>
 #include <asyncnet/Response.hpp>
+#include <asyncnet/ResponseStream.hpp>
+#include <asyncnet/StreamingResponse.hpp>
 #include <asyncnet/NetworkTask.hpp>
+#include <asyncnet/detail/MultiEngine.hpp>
 
 #include <curlpp/Easy.hpp>
+#include <coro/task.hpp>
 #include <coro/thread_pool.hpp>
+#include <concepts>
+#include <ranges>
+#include <vector>
 // #include <expected>
 
 namespace asyncnet {
 
+	/**
+	 * The way @ref Requestor performs requests
+	 */
+	enum class RequestorEngine {
+		/// Every request occupies one pool thread until it's done. worker_count is the maximum count of parallel requests
+		ThreadPool,
+		/// Requests are driven by curl_multi event loops. worker_count is the count of event loops, each one can perform thousands of requests
+		EventLoop,
+		/// Event loops, which are pinned to CPU cores. Requests are routed by origin, so connections of one origin stay warm in one loop's cache.
+		/// worker_count is the count of shards, usually count of cores. By default user code after request is executed on the shard thread
+		Sharded
+	};
+
 	class Requestor {
 	public:
 		/**
-		 * Constructs with thread pool with worker_count size. After request user code executed in another special thread
+		 * Constructs with thread pool with worker_count size. After request user code executed in another special thread,
+		 * except for @ref RequestorEngine::Sharded, which executes it on the shard thread
 		 * @param worker_count Threads count to execute in parallel for requests
+		 * @param engine The way to perform requests
 		 */
-		explicit Requestor(const unsigned worker_count);
+		explicit Requestor(const unsigned worker_count, const RequestorEngine engine = RequestorEngine::ThreadPool);
 
 		/**
-		 * Constructs with thread pool with worker_count size. After request user code executed on executor_pool thread
+		 * Constructs with thread pool with worker_count size. After request user code executed on executor_pool thread.
+		 * If executor_pool is nullptr, user code executed on the worker thread. Note that for @ref RequestorEngine::EventLoop it blocks the event loop
 		 * @param worker_count Threads count to execute in parallel for requests
 		 * @param executor_pool The pool to execute after performing request
+		 * @param engine The way to perform requests
+		 */
+		explicit Requestor(const unsigned worker_count, std::shared_ptr<coro::thread_pool> executor_pool, const RequestorEngine engine = RequestorEngine::ThreadPool);
+
+#if defined(__linux__)
+		/**
+		 * Constructs without own threads. Requests are driven by curl_multi event loop, which runs as the scheduler task and polls sockets with the scheduler.
+		 * After request user code executed on the scheduler, so no thread switches are made.
+		 * The scheduler must not be shut down while the requestor or its copies are alive
+		 * @param scheduler The scheduler to perform requests and execute after performing request
 		 */
-		explicit Requestor(const unsigned worker_count, std::shared_ptr<coro::thread_pool> executor_pool);
+		explicit Requestor(std::shared_ptr<coro::io_scheduler> scheduler);
+#endif
 
 		Requestor(const Requestor& other) = default;
 		Requestor(Requestor&& other) = default;
@@ -31,22 +67,151 @@ namespace asyncnet {
 
 		/**
 		 * Switches to Requestor's thread, perfroms request, and then switches to special or executor_pool thread depending on construction @ref Requestor::Requestor.
-		 * If timedout the @ref NetworkRuntimeError code will be @ref TimeoutErrorCode, if cancelled the code will be @ref CancelledErrorCode
+		 * If timedout the @ref NetworkRuntimeError code will be @ref TimeoutErrorCode, if cancelled the code will be @ref CancelledErrorCode.
+		 * Request, which waits for a worker or is performed by @ref RequestorEngine::EventLoop, is cancelled at once by @ref NetworkTask::request_stop.
+		 * Request, which is performed by @ref RequestorEngine::ThreadPool worker, is cancelled on the next curl progress callback
+		 * Expired timeouts raise @ref TimeoutError, its @ref TimeoutError::kind tells which timeout expired.
 		 * @param handle The handle to execute asyncronously 
+		 * @param options Options of request, which made the handle, see @ref Request::get_perform_options
 		 * @return Retuns awaitable task
 		 * @throws NetworkRuntimeError If any runtime error
 		 * @throws NetworkLogicError If any logic error
 		 */
-		NetworkTask perform_handle(curlpp::Easy handle) const throw();
+		NetworkTask perform_handle(curlpp::Easy handle, PerformOptions options = {}) const throw();
 
 		/** @copydoc perform_handle(handle)
 		 * Grabs handle from request and performs it
 		 */
 		NetworkTask perform_request(const Request& request) const throw();
 
+		/**
+		 * Starts request, which body is read by chunks while it's transferred, so the body is never kept in memory as a whole.
+		 * When buffer_size bytes aren't read yet, event loop pauses the transfer with CURL_WRITEFUNC_PAUSE and @ref RequestorEngine::ThreadPool worker waits for the reader.
+		 * Paused transfer counts as idle for @ref Request::set_idle_timeout. Requestor must outlive the response
+		 * @param request The request to perform
+		 * @param buffer_size Count of received bytes, above which the transfer waits for the reader
+		 * @return Returns response with body chunks, see @ref StreamingResponse::next_chunk
+		 */
+		StreamingResponse perform_streaming(const Request& request, const size_t buffer_size = StreamingResponse::default_buffer_size) const;
+
+		/**
+		 * Starts every request of the range at once and returns stream of their completions in completion order.
+		 * For event loop engines the whole range is submitted to every loop under one lock with one wake up, and the stream waiter is woken once per loop iteration instead of once per request.
+		 * Requests with @ref ConcurrencyLimiter or @ref RequestorEngine::ThreadPool are admitted one by one like @ref perform_request, only their completions are gathered by the stream.
+		 * Requestor must outlive the stream
+		 * @param requests Requests to perform
+		 * @return Returns stream of results, see @ref ResponseStream::next
+		 */
+		template<std::ranges::input_range Range>
+			requires std::derived_from<std::remove_cvref_t<std::ranges::range_reference_t<Range>>, Request>
+		ResponseStream perform_many_stream(Range&& requests) const {
+			std::vector<curlpp::Easy> handles;
+			std::vector<PerformOptions> options;
+			if constexpr (std::ranges::sized_range<Range>) {
+				handles.reserve(std::ranges::size(requests));
+				options.reserve(std::ranges::size(requests));
+			}
+
+			for (const Request& request : requests) {
+				handles.push_back(request.make_request_handle());
+				options.push_back(request.get_perform_options());
+			}
+			return perform_handles(std::move(handles), std::move(options));
+		}
+
+		/**
+		 * Performs every request of the range at once, see @ref perform_many_stream. Never throws on network errors, see @ref BatchResult::error
+		 * @param requests Requests to perform
+		 * @return Returns awaitable task with result for every request in the range order
+		 */
+		template<std::ranges::input_range Range>
+			requires std::derived_from<std::remove_cvref_t<std::ranges::range_reference_t<Range>>, Request>
+		coro::task<std::vector<BatchResult>> perform_many(Range&& requests) const {
+			return collect(perform_many_stream(std::forward<Range>(requests)));
+		}
+
+		/**
+		 * Set the pool to share connections, DNS cache and TLS sessions between requests. If passed nullptr, every request makes new connection.
+		 * By default no pool is used. Affects only requests performed after the call
+		 * @param connection_pool The pool to use or nullptr
+		 */
+		void set_connection_pool(std::shared_ptr<ConnectionPool> connection_pool);
+
+		/**
+		 * @return Returns current connection pool, nullptr if none
+		 */
+		const std::shared_ptr<ConnectionPool>& get_connection_pool() const noexcept;
+
+		/**
+		 * Set the limiter of requests performed at once. Requests above the limits wait in the limiter queue. If passed nullptr, requests aren't limited.
+		 * The limiter can be shared between requestors to limit them together. By default no limiter is used. Affects only requests performed after the call
+		 * @param concurrency_limiter The limiter to use or nullptr
+		 */
+		void set_concurrency_limiter(std::shared_ptr<ConcurrencyLimiter> concurrency_limiter);
+
+		/**
+		 * @return Returns current concurrency limiter, nullptr if none
+		 */
+		const std::shared_ptr<ConcurrencyLimiter>& get_concurrency_limiter() const noexcept;
+
+		/**
+		 * Set maximum count of workers, which requests of the priority can occupy at once, so lower priorities can't take all workers.
+		 * Takes effect only for @ref RequestorEngine::ThreadPool, for event loops use @ref ConcurrencyLimiter::Options::max_in_flight_per_priority.
+		 * Copies of the requestor share the limits
+		 * @param priority Priority to limit
+		 * @param max_workers Maximum count of workers or @ref std::nullopt for no limit
+		 */
+		void set_max_workers(const RequestPriority priority, const std::optional<size_t>& max_workers);
+
+		/**
+		 * Set weight of the tenant for workers of @ref RequestorEngine::ThreadPool and for current concurrency limiter, see @ref ConcurrencyLimiter::set_tenant_weight.
+		 * While requestor is saturated, every waiting tenant gets share proportional to its weight. Copies of the requestor share the weights
+		 * @param tenant Tenant to change, see @ref Request::set_tenant
+		 * @param weight New weight. By default every tenant has weight 1
+		 */
+		void set_tenant_weight(const std::string& tenant, const unsigned weight);
+
+		/**
+		 * Set maximum count of HTTP/2 streams multiplexed on one connection. When the limit is reached, the next request to the origin makes new connection.
+		 * Takes effect only for @ref RequestorEngine::EventLoop and requests with HTTP/2 @ref Request::set_http_version. By default 100 streams
+		 * @param max_streams Maximum streams count per connection
+		 */
+		void set_max_concurrent_streams(const long max_streams);
+
+		/**
+		 * Enables work stealing for @ref RequestorEngine::Sharded. When shard of request origin is busy, the request goes to an idle shard.
+		 * Disabled by default. Copies of the requestor share the setting
+		 * @param threshold Count of active requests, starting from which the shard is busy. If @ref std::nullopt, stealing is disabled
+		 */
+		void set_work_stealing(const std::optional<size_t>& threshold);
+
+	protected:
+		/**
+		 * Performs the request with every owner of connection cache, which serves the request origin, so every owner gets its own connections.
+		 * Owners are every event loop, the origin shard for @ref RequestorEngine::Sharded, or every pool worker for @ref RequestorEngine::ThreadPool.
+		 * Pool worker can't be chosen, so pool requests are started together to occupy every worker. Worker performs one transfer at a time, so it gets one request
+		 * @param request The request to perform
+		 * @param connections Count of parallel requests for every event loop
+		 * @return Returns not started tasks of the requests
+		 */
+		std::vector<NetworkTask> perform_per_owner(const Request& request, const unsigned connections) const;
+
 	private:
+		/**
+		 * @param engine The loop to perform the transfer, or nullptr to pick it by origin
+		 */
+		NetworkTask perform(curlpp::Easy handle, PerformOptions options, std::shared_ptr<detail::BodyChannel> body_channel, detail::MultiEngine* engine) const;
+
+		ResponseStream perform_handles(std::vector<curlpp::Easy> handles, std::vector<PerformOptions> options) const;
+
+		static coro::task<std::vector<BatchResult>> collect(ResponseStream stream);
 
 		std::shared_ptr<coro::thread_pool> pool_;
+		/// Gives pool workers to requests by priority, so the pool queue doesn't keep requests in arrival order
+		std::shared_ptr<ConcurrencyLimiter> worker_limiter_;
 		std::shared_ptr<coro::thread_pool> after_pool_;
+		std::shared_ptr<detail::EngineGroup> engines_;
+		std::shared_ptr<ConnectionPool> connection_pool_;
+		std::shared_ptr<ConcurrencyLimiter> concurrency_limiter_;
 	};
 }
\ No newline at end of file
@@ -1,13 +1,21 @@
 #pragma once
+#include <asyncnet/JsonFieldExtractor.hpp>
+#include <asyncnet/NetTypes.hpp>
+#include <asyncnet/ResponseBody.hpp>
+#include <asyncnet/ResponseHeaders.hpp>
+
 #include <curlpp/Easy.hpp>
-#include <sstream>
 #include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
 
 namespace asyncnet {
 	class Response {
 	public:
 		explicit Response(curlpp::Easy handle);
-		explicit Response(curlpp::Easy handle, std::ostringstream&& text_stream);
+		explicit Response(curlpp::Easy handle, ResponseBody&& body, ResponseHeaders&& headers, boost::system::error_code json_error = {});
+		explicit Response(curlpp::Easy handle, boost::json::value&& json, ResponseHeaders&& headers);
 
 		Response(const Response& other) = delete;
 		Response(Response&& other) = default;
@@ -24,8 +32,119 @@ namespace asyncnet {
 		 */
 		std::string get_text() const;
 
+		/**
+		 * Get response body as one block, see @ref ResponseBody::view. Body of several chunks is copied into one block on the first call
+		 * @return View of response body, valid while the response is alive
+		 */
+		std::string_view get_text_view() const;
+
+		/**
+		 * Get response body buffer, which can be read by chunks without joining them, see @ref ResponseBody::chunks
+		 * @return Response body
+		 */
+		const ResponseBody& get_body() const noexcept;
+
+		/**
+		 * Moves response body out, see @ref ResponseBody::release. The response body is empty after the call
+		 * @return Response body
+		 */
+		std::string take_text();
+
+		/**
+		 * Get response body parsed while it was received, see @ref Request::set_body_mode
+		 * @return Parsed body, null for empty body
+		 * @throws std::logic_error If request wasn't performed with @ref ResponseBodyMode::Json or body isn't JSON by Content-Type, so it's kept as text
+		 * @throws boost::system::system_error If body is invalid JSON, see @ref get_json_error
+		 */
+		const boost::json::value& get_json() const;
+
+		/**
+		 * Moves parsed response body out, see @ref get_json
+		 * @return Parsed body, null for empty body
+		 * @throws std::logic_error If request wasn't performed with @ref ResponseBodyMode::Json or body isn't JSON by Content-Type, so it's kept as text
+		 * @throws boost::system::system_error If body is invalid JSON, see @ref get_json_error
+		 */
+		boost::json::value take_json();
+
+		/**
+		 * Get error of body parsed with @ref ResponseBodyMode::Json. Invalid body doesn't fail the request, so its status is still known
+		 * @return Parse error or empty error code if body is parsed
+		 */
+		boost::system::error_code get_json_error() const noexcept;
+
+		/**
+		 * Parse response body as JSON. Document gets own @ref boost::json::monotonic_resource, so its nodes are bump-pointer allocated
+		 * and freed at once, when the document and its copies are destroyed
+		 * @return Parsed body
+		 * @throws boost::system::system_error If parse failed
+		 */
+		boost::json::value parse_json() const;
+
+		/**
+		 * Parse response body as JSON into the storage
+		 * @param storage Storage to allocate document from
+		 * @return Parsed body
+		 * @throws boost::system::system_error If parse failed
+		 */
+		boost::json::value parse_json(boost::json::storage_ptr storage) const;
+
+		/**
+		 * Extract values at JSON Pointers from response body without building DOM, see @ref JsonFieldExtractor
+		 * @param pointers JSON Pointers of values to extract, like "/data/0/id"
+		 * @return Value for every pointer in the same order or @ref std::nullopt if body has no such value
+		 * @throws std::invalid_argument If pointer is invalid
+		 * @throws boost::system::system_error If body is invalid JSON
+		 */
+		std::vector<std::optional<boost::json::value>> extract_json_fields(const std::vector<std::string>& pointers) const;
+
+		/**
+		 * Parse response body into T, see @ref parse_json_as. Body parsed with @ref ResponseBodyMode::Json is converted with @ref boost::json::value_to
+		 * @tparam T The type to parse into
+		 * @return Parsed body
+		 * @throws boost::system::system_error If parse or conversion failed
+		 */
+		template<typename T>
+		T json_as() const {
+			if (json_error_) {
+				throw boost::system::system_error(json_error_);
+			}
+			if (json_) {
+				return boost::json::value_to<T>(*json_);
+			}
+			return parse_json_as<T>(body_.view());
+		}
+
+		/**
+		 * Get headers of the final response
+		 * @return Response headers
+		 */
+		const ResponseHeaders& get_headers() const noexcept;
+
+		/**
+		 * Get the first response header with the name, see @ref ResponseHeaders::get
+		 * @param name Header name in any case
+		 * @return Header value, valid while the response is alive, or @ref std::nullopt if there is no such header
+		 */
+		std::optional<std::string_view> get_header(std::string_view name) const;
+
+		/**
+		 * Get transfer information, see curl_easy_getinfo
+		 * @tparam T Type of the information value
+		 * @param info The information to get
+		 * @return Returns the information value
+		 */
+		template<typename T>
+		T get_info(const CURLINFO info) const {
+			T value{};
+			handle_.getCurlHandle().getInfo(info, value);
+			return value;
+		}
+
 	private:
 		curlpp::Easy handle_;
-		std::optional<std::ostringstream> stream_;
+		ResponseBody body_;
+		std::optional<boost::json::value> json_;
+		boost::system::error_code json_error_;
+		ResponseHeaders headers_;
 	};
 }
\ No newline at end of file
@@ -0,0 +1,114 @@
+#pragma once
+#include <array>
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace asyncnet {
+
+	/**
+	 * Response body buffer. Tiny body is kept inline, bigger body is collected into fixed-size slabs reused between responses,
+	 * or into a single block reserved by Content-Length, so growing body is never reallocated and copied.
+	 * Slabs are kept after the transfer, so body read by chunks is never copied. Body of several chunks is joined into one block
+	 * only when it's viewed as a whole. Const methods may be called from several threads and their views stay stable
+	 */
+	class ResponseBody {
+	public:
+		/// Body up to this size is kept inline without allocations
+		static constexpr size_t inline_capacity = 256;
+		/// Size of one slab, equal to the biggest chunk curl passes to the write callback
+		static constexpr size_t slab_size = 16 * 1024;
+		/// Count of zero bytes after @ref padded_view, which SIMD parsers may read past the end
+		static constexpr size_t tail_padding = 64;
+
+		ResponseBody() = default;
+		ResponseBody(const ResponseBody& other) = delete;
+		ResponseBody(ResponseBody&& other) noexcept;
+		ResponseBody& operator=(const ResponseBody& other) = delete;
+		ResponseBody& operator=(ResponseBody&& other) noexcept;
+		~ResponseBody();
+
+		/**
+		 * Reserves contiguous storage for the expected body. Does nothing if data is already appended or the body fits inline
+		 * @param capacity Expected body size, usually Content-Length
+		 */
+		void reserve(const size_t capacity);
+
+		/**
+		 * Appends data to the end of body
+		 * @param data Data to append
+		 * @param size Size of data
+		 */
+		void append(const char* data, const size_t size);
+
+		/**
+		 * Adds @ref tail_padding zero bytes after the body, so it can be viewed by @ref padded_view. Body of several chunks gets the padding
+		 * when it's joined. Called once, when the transfer is done. Appending data after the call makes the body unfinished again
+		 */
+		void finish();
+
+		/**
+		 * @return Returns body size in bytes
+		 */
+		size_t size() const noexcept;
+
+		/**
+		 * @return Returns true if body is empty
+		 */
+		bool empty() const noexcept;
+
+		/**
+		 * Views body as one block. Body of several chunks is joined into a copy on the first call, the join is thread safe
+		 * @return Returns view of the whole body, valid until the body is changed or destroyed
+		 */
+		std::string_view view() const;
+
+		/**
+		 * Views body like @ref view, which is followed by @ref tail_padding zero bytes added by @ref finish
+		 * @return Returns view of the whole body, valid until the body is changed or destroyed
+		 * @throws std::logic_error If body isn't finished, see @ref finish
+		 */
+		std::string_view padded_view() const;
+
+		/**
+		 * Views body chunks in order without joining or copying them
+		 * @return Returns views of chunks, valid until the body is changed or destroyed
+		 */
+		std::vector<std::string_view> chunks() const;
+
+		/**
+		 * Moves body out. Body reserved by Content-Length or already joined is moved without copying. The body is empty after the call
+		 * @return Returns the body text
+		 */
+		std::string release();
+
+	private:
+		struct Slab {
+			std::unique_ptr<char[]> data;
+			size_t size = 0;
+		};
+
+		void spill_inline();
+		std::string_view joined_view() const;
+		std::string join() const;
+		void reset_joined() noexcept;
+		void release_slabs() noexcept;
+
+		std::array<char, inline_capacity + tail_padding> inline_data_;
+		bool is_inline_ = true;
+		size_t size_ = 0;
+		/// Padding is added after the body
+		bool is_finished_ = false;
+		/// The first chunk, reserved or joined, when body isn't inline. Padding of finished body is kept after the data
+		std::string head_;
+		/// Chunks after the head
+		std::vector<Slab> slabs_;
+		/// Copy of head and slabs followed by the padding, made on the first view of the whole body
+		mutable std::string joined_;
+		mutable std::atomic<bool> is_joined_ = false;
+		mutable std::mutex join_mutex_;
+	};
+}
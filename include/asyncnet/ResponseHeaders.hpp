@@ -0,0 +1,119 @@
+#pragma once
+#include <array>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace asyncnet {
+
+	/**
+	 * Frequent response headers, which are found without comparing names
+	 */
+	enum class HeaderName {
+		ContentType,
+		ContentLength,
+		ContentEncoding,
+		TransferEncoding,
+		Location,
+		ETag,
+		LastModified,
+		CacheControl,
+		Expires,
+		Date,
+		RetryAfter,
+		SetCookie,
+		Connection,
+		Server
+	};
+
+	/**
+	 * One response header field
+	 */
+	struct HeaderField {
+		std::string_view name;
+		std::string_view value;
+	};
+
+	/**
+	 * Headers of the final response. Every field is kept in one arena and indexed by offsets, so capturing headers doesn't allocate per field.
+	 * Names are compared case-insensitive and keep the server case
+	 */
+	class ResponseHeaders {
+	public:
+		ResponseHeaders();
+
+		/**
+		 * Adds one raw header line, as curl passes it to the header callback.
+		 * Status line starts headers of the next response, like after redirect or "100 Continue", so previous headers are dropped.
+		 * Folded continuation lines and the empty line after headers are skipped
+		 * @param data Header line with line ending
+		 * @param size Size of line
+		 */
+		void append_line(const char* data, const size_t size);
+
+		/**
+		 * @return Returns count of header fields
+		 */
+		size_t size() const noexcept;
+
+		/**
+		 * @return Returns true if there is no header fields
+		 */
+		bool empty() const noexcept;
+
+		/**
+		 * @param index Index of field in received order, less than @ref size
+		 * @return Returns the field, valid while headers are alive and not changed
+		 */
+		HeaderField at(const size_t index) const;
+
+		/**
+		 * Finds the first header with the name
+		 * @param name Header name in any case
+		 * @return Returns header value or @ref std::nullopt if there is no such header
+		 */
+		std::optional<std::string_view> get(std::string_view name) const;
+
+		/**
+		 * Finds the first frequent header in constant time
+		 * @param name The header
+		 * @return Returns header value or @ref std::nullopt if there is no such header
+		 */
+		std::optional<std::string_view> get(const HeaderName name) const;
+
+		/**
+		 * Finds every header with the name, like repeated Set-Cookie
+		 * @param name Header name in any case
+		 * @return Returns values in received order
+		 */
+		std::vector<std::string_view> get_all(std::string_view name) const;
+
+		/**
+		 * @param name Header name in any case
+		 * @return Returns true if there is a header with the name
+		 */
+		bool contains(std::string_view name) const;
+
+	private:
+		struct Entry {
+			uint32_t name_offset;
+			uint32_t name_size;
+			uint32_t value_offset;
+			uint32_t value_size;
+		};
+
+		static constexpr size_t known_header_count = static_cast<size_t>(HeaderName::Server) + 1;
+		static constexpr uint32_t no_entry = UINT32_MAX;
+
+		void clear() noexcept;
+		std::string_view name_of(const Entry& entry) const noexcept;
+		std::string_view value_of(const Entry& entry) const noexcept;
+
+		std::string arena_;
+		std::vector<Entry> entries_;
+		/// Index of the first entry of every frequent header
+		std::array<uint32_t, known_header_count> known_entries_;
+	};
+}
@@ -0,0 +1,106 @@
+#pragma once
+#include <asyncnet/Response.hpp>
+#include <asyncnet/detail/MultiEngine.hpp>
+
+#include <coro/task.hpp>
+#include <coro/thread_pool.hpp>
+#include <exception>
+#include <memory>
+#include <optional>
+#include <vector>
+
+namespace asyncnet {
+
+	/**
+	 * Result of one request of @ref Requestor::perform_many
+	 */
+	struct BatchResult {
+		/// Index of the request in the batch
+		size_t index = 0;
+		/// Response if request succeeded
+		std::optional<Response> response;
+		/// Error if request failed, nullptr if succeeded
+		std::exception_ptr error;
+	};
+
+	namespace detail {
+
+		/**
+		 * Requests of one batch, which are performed together and push their indexes to @ref completions when done
+		 */
+		class ResponseBatch {
+		public:
+			explicit ResponseBatch(const size_t size);
+			ResponseBatch(const ResponseBatch& other) = delete;
+			ResponseBatch(ResponseBatch&& other) = delete;
+			virtual ~ResponseBatch() = default;
+
+			/**
+			 * @return Returns count of requests in the batch
+			 */
+			size_t size() const noexcept;
+
+			/**
+			 * @return Returns queue of done requests
+			 */
+			CompletionQueue& completions() noexcept;
+
+			/**
+			 * Thread safe cancels every request, which isn't done yet
+			 */
+			virtual void request_stop() noexcept = 0;
+
+			/**
+			 * Makes result of done request. Called once for every request
+			 * @param index Index of done request
+			 * @return Returns the request result
+			 */
+			virtual BatchResult take(const size_t index) = 0;
+
+		protected:
+			std::shared_ptr<CompletionQueue> completions_;
+		};
+	}
+
+	/**
+	 * Async stream of @ref Requestor::perform_many completions in completion order.
+	 * Requests are performed from the stream creation, so completions are gathered even if nobody waits for them.
+	 * Destroying the stream cancels requests, which aren't done yet
+	 */
+	class ResponseStream {
+	public:
+		explicit ResponseStream(std::shared_ptr<detail::ResponseBatch> batch, std::shared_ptr<coro::thread_pool> after_pool);
+		ResponseStream(const ResponseStream& other) = delete;
+		ResponseStream(ResponseStream&& other) noexcept = default;
+		ResponseStream& operator=(const ResponseStream& other) = delete;
+		ResponseStream& operator=(ResponseStream&& other) noexcept = default;
+		~ResponseStream();
+
+		/**
+		 * Waits for the next done requests. The waiting coroutine is woken once for all requests done by one event loop iteration,
+		 * and then is switched to executor pool of the requestor like after @ref Requestor::perform_request
+		 * @return Returns awaitable task with results in completion order, empty if every request was already taken
+		 */
+		coro::task<std::vector<BatchResult>> next();
+
+		/**
+		 * @return Returns count of requests in the batch
+		 */
+		size_t size() const noexcept;
+
+		/**
+		 * @return Returns true if every request result was taken by @ref next
+		 */
+		bool done() const noexcept;
+
+		/**
+		 * Thread safe cancels every request, which isn't done yet. Cancelled requests result in @ref NetworkRuntimeError with @ref CancelledErrorCode
+		 */
+		void request_stop() noexcept;
+
+	private:
+		std::shared_ptr<detail::ResponseBatch> batch_;
+		std::shared_ptr<coro::thread_pool> after_pool_;
+		size_t taken_ = 0;
+	};
+}
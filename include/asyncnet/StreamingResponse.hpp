@@ -0,0 +1,51 @@
+#pragma once
+#include <asyncnet/detail/BodyChannel.hpp>
+
+#include <coro/task.hpp>
+#include <coro/thread_pool.hpp>
+#include <memory>
+#include <optional>
+#include <string>
+
+namespace asyncnet {
+
+	/**
+	 * Response, which body is read by chunks while the transfer is running, see @ref Requestor::perform_streaming.
+	 * Not read chunks occupy at most the buffer size, then the transfer waits for the reader.
+	 * Destroying the response before the body is over cancels the transfer
+	 */
+	class StreamingResponse {
+	public:
+		/// Default count of buffered bytes, above which the transfer waits for the reader
+		static constexpr size_t default_buffer_size = 1024 * 1024;
+
+		explicit StreamingResponse(std::shared_ptr<detail::BodyChannel> channel, std::shared_ptr<coro::thread_pool> after_pool);
+		StreamingResponse(const StreamingResponse& other) = delete;
+		StreamingResponse(StreamingResponse&& other) noexcept = default;
+		StreamingResponse& operator=(const StreamingResponse& other) = delete;
+		StreamingResponse& operator=(StreamingResponse&& other) noexcept = default;
+		~StreamingResponse();
+
+		/**
+		 * Waits for the next body chunk. Reader is switched to executor pool of the requestor like after @ref Requestor::perform_request
+		 * @return Returns awaitable task with the chunk or @ref std::nullopt, when the body is over
+		 * @throws NetworkRuntimeError If transfer failed, after every received chunk was read
+		 */
+		coro::task<std::optional<std::string>> next_chunk();
+
+		/**
+		 * Get HTTP status code
+		 * @return HTTP status code, which is known after the first chunk or the end of body, otherwise 0
+		 */
+		long get_status_code() const;
+
+		/**
+		 * Thread safe cancels the transfer. Reader gets @ref NetworkRuntimeError with @ref CancelledErrorCode after already received chunks
+		 */
+		void request_stop() noexcept;
+
+	private:
+		std::shared_ptr<detail::BodyChannel> channel_;
+		std::shared_ptr<coro::thread_pool> after_pool_;
+	};
+}
@@ -0,0 +1,111 @@
+#pragma once
+#include <asyncnet/detail/MultiEngine.hpp>
+
+#include <condition_variable>
+#include <coroutine>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <mutex>
+#include <optional>
+#include <stop_token>
+#include <string>
+
+namespace asyncnet::detail {
+
+	/**
+	 * Bounded buffer of response body chunks between running transfer and consuming coroutine.
+	 * When the buffer is full, transfer driven by @ref MultiEngine is paused with CURL_WRITEFUNC_PAUSE and continued when the consumer frees a half of the buffer.
+	 * Blocking transfer waits for free space on its worker thread instead
+	 */
+	class BodyChannel {
+	public:
+		class ReadAwaitable {
+		public:
+			explicit ReadAwaitable(BodyChannel& channel) noexcept;
+
+			bool await_ready() const;
+
+			bool await_suspend(std::coroutine_handle<> coroutine);
+
+			/**
+			 * @return Returns the next chunk or @ref std::nullopt if body is over
+			 * @throws Rethrows transfer error, when every chunk was read
+			 */
+			std::optional<std::string> await_resume();
+
+		private:
+			BodyChannel& channel_;
+		};
+
+		/**
+		 * @param max_buffered Count of bytes, above which the transfer is paused. Single chunk is always accepted
+		 */
+		explicit BodyChannel(const size_t max_buffered);
+		BodyChannel(const BodyChannel& other) = delete;
+		BodyChannel(BodyChannel&& other) = delete;
+
+		/**
+		 * Drives the channel by the event loop: full buffer pauses transfer and consumer is resumed after the loop iteration.
+		 * Must be called before the transfer is started
+		 * @param engine The loop, which performs the transfer
+		 */
+		void attach(MultiEngine* engine) noexcept;
+
+		/**
+		 * Curl write callback
+		 * @param easy The transfer handle
+		 * @param data Received data
+		 * @param size Size of data
+		 * @return Returns size if data is taken, CURL_WRITEFUNC_PAUSE if the transfer must be paused or 0 if channel is cancelled
+		 */
+		size_t write(CURL* easy, const char* data, const size_t size);
+
+		/**
+		 * Ends the body. The consumer is resumed on the calling thread
+		 * @param error Transfer error or nullptr
+		 * @param status_code HTTP status code of done transfer, if body had no chunks
+		 */
+		void close(std::exception_ptr error, const long status_code = 0) noexcept;
+
+		/**
+		 * Thread safe sets stop source of the transfer. Stop is requested at once, if the channel is already cancelled
+		 * @param stop_source Source, which stops the transfer
+		 */
+		void set_stop_source(std::stop_source stop_source);
+
+		/**
+		 * Thread safe stops the transfer. Blocked writer is woken and the next writes fail, the body ends with @ref CancelledErrorCode
+		 */
+		void cancel() noexcept;
+
+		/**
+		 * Waits for the next chunk. Only one coroutine can wait at once
+		 * @return Returns awaitable, which results in the chunk or @ref std::nullopt if body is over
+		 */
+		ReadAwaitable read() noexcept;
+
+		/**
+		 * @return Returns HTTP status code, which is known since the first chunk, otherwise 0
+		 */
+		long status_code() const;
+
+	private:
+		std::optional<std::string> take();
+
+		mutable std::mutex mutex_;
+		std::condition_variable space_;
+		std::deque<std::string> chunks_;
+		size_t buffered_ = 0;
+		const size_t max_buffered_;
+		std::coroutine_handle<> waiter_ = nullptr;
+		MultiEngine* engine_ = nullptr;
+		/// Id of the paused event loop transfer
+		std::optional<uint64_t> paused_id_;
+		std::stop_source stop_source_{ std::nostopstate };
+		long status_code_ = 0;
+		bool closed_ = false;
+		bool cancelled_ = false;
+		std::exception_ptr error_;
+	};
+}
@@ -0,0 +1,127 @@
+#pragma once
+#include <atomic>
+#include <coroutine>
+#include <exception>
+#include <memory>
+#include <optional>
+#include <stop_token>
+
+namespace asyncnet::detail {
+
+	/**
+	 * Coroutine, which starts at once and destroys itself when done
+	 */
+	struct DetachedTask {
+		struct promise_type {
+			DetachedTask get_return_object() noexcept {
+				return {};
+			}
+
+			std::suspend_never initial_suspend() noexcept {
+				return {};
+			}
+
+			std::suspend_never final_suspend() noexcept {
+				return {};
+			}
+
+			void return_void() noexcept {
+
+			}
+
+			void unhandled_exception() noexcept {
+				std::terminate();
+			}
+		};
+	};
+
+	/**
+	 * Awaitable, which switches to the executor thread, like executor->schedule(), but can be cancelled while waiting in the executor queue.
+	 * On cancellation the coroutine is resumed at once on the thread, which requested stop, and the queued executor job becomes no-op
+	 * @tparam Executor coro::thread_pool or coro::io_scheduler
+	 */
+	template<typename Executor>
+	class CancellableSchedule {
+	public:
+		explicit CancellableSchedule(std::shared_ptr<Executor> executor, std::stop_token stop_token) noexcept :
+			executor_(std::move(executor)),
+			stop_token_(std::move(stop_token)),
+			state_(std::make_shared<State>())
+		{
+
+		}
+
+		// stop callback keeps pointer to the awaitable
+		CancellableSchedule(const CancellableSchedule& other) = delete;
+		CancellableSchedule(CancellableSchedule&& other) = delete;
+
+		bool await_ready() const noexcept {
+			return stop_token_.stop_requested();
+		}
+
+		bool await_suspend(std::coroutine_handle<> coroutine) {
+			state_->continuation = coroutine;
+
+			stop_callback_.emplace(stop_token_, Canceller{ state_ });
+
+			int expected = registering;
+			if (!state_->status.compare_exchange_strong(expected, armed)) {
+				// stopped while registering
+				return false;
+			}
+
+			resume_on(executor_, state_);
+			return true;
+		}
+
+		/**
+		 * @return Returns true if switched to the executor, false if cancelled
+		 */
+		bool await_resume() const noexcept {
+			return !stop_token_.stop_requested() || state_->scheduled;
+		}
+
+	private:
+		static constexpr int registering = 0;
+		static constexpr int armed = 1;
+		static constexpr int claimed = 2;
+
+		struct State {
+			std::atomic<int> status = registering;
+			std::coroutine_handle<> continuation = nullptr;
+			bool scheduled = false;
+		};
+
+		struct Canceller {
+			void operator()() const noexcept {
+				int status = state->status.load();
+				while (status != claimed) {
+					if (state->status.compare_exchange_weak(status, claimed)) {
+						// if not armed yet, await_suspend won't suspend
+						if (status == armed) {
+							state->continuation.resume();
+						}
+						return;
+					}
+				}
+			}
+
+			std::shared_ptr<State> state;
+		};
+
+		static DetachedTask resume_on(std::shared_ptr<Executor> executor, std::shared_ptr<State> state) {
+			co_await executor->schedule();
+
+			int expected = armed;
+			if (state->status.compare_exchange_strong(expected, claimed)) {
+				state->scheduled = true;
+				state->continuation.resume();
+			}
+		}
+
+		std::shared_ptr<Executor> executor_;
+		std::stop_token stop_token_;
+		std::shared_ptr<State> state_;
+		std::optional<std::stop_callback<Canceller>> stop_callback_;
+	};
+}
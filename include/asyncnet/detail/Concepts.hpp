@@ -17,4 +17,13 @@ namespace asyncnet::detail {
 
 	template<typename T>
 	concept stringlike = same_as_any_of<T, std::string, std::string_view>;
+
+	template<typename T, template<typename ...> typename Template>
+	constexpr bool is_specialization_of = false;
+
+	template<template<typename ...> typename Template, typename ... Args>
+	constexpr bool is_specialization_of<Template<Args ...>, Template> = true;
+
+	template<typename T, template<typename ...> typename Template>
+	concept specialization_of = is_specialization_of<T, Template>;
 };
\ No newline at end of file
@@ -0,0 +1,55 @@
+#pragma once
+#include <cstddef>
+
+#pragma warning(push, 0)
+#include <boost/json.hpp>
+#pragma warning(pop)
+
+namespace asyncnet::detail {
+
+	/**
+	 * Parses response body as JSON chunk by chunk from the curl write callback, so parsing overlaps the transfer and the raw body isn't kept
+	 */
+	class JsonBodyParser {
+	public:
+		/**
+		 * @param storage Storage of the parsed value
+		 */
+		explicit JsonBodyParser(boost::json::storage_ptr storage);
+		JsonBodyParser(const JsonBodyParser& other) = delete;
+		JsonBodyParser(JsonBodyParser&& other) = delete;
+
+		/**
+		 * Curl write callback
+		 * @param data Received data
+		 * @param size Size of data
+		 * @return Returns size, data after invalid JSON is skipped, so the transfer completes and its status is known
+		 */
+		size_t write(const char* data, const size_t size);
+
+		/**
+		 * @return Returns true if received data is invalid JSON
+		 */
+		bool failed() const noexcept;
+
+		/**
+		 * Ends parsing after the transfer is done
+		 * @return Returns parsed value or null for empty body
+		 * @throws boost::system::system_error If body is invalid or incomplete JSON
+		 */
+		boost::json::value finish();
+
+		/**
+		 * Ends parsing after the transfer is done
+		 * @param error Set to parse error if body is invalid or incomplete JSON
+		 * @return Returns parsed value, null for empty body or invalid JSON
+		 */
+		boost::json::value finish(boost::system::error_code& error);
+
+	private:
+		boost::json::storage_ptr storage_;
+		boost::json::stream_parser parser_;
+		boost::system::error_code error_;
+		bool is_empty_ = true;
+	};
+}
@@ -0,0 +1,311 @@
+#pragma once
+#include <asyncnet/detail/Concepts.hpp>
+
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <map>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <unordered_map>
+#include <vector>
+
+#pragma warning(push, 0)
+#include <boost/describe.hpp>
+#include <boost/json.hpp>
+#include <boost/mp11/algorithm.hpp>
+#pragma warning(pop)
+
+namespace asyncnet::detail {
+
+	template<typename Pointer>
+	struct member_pointer_type;
+
+	template<typename Class, typename Member>
+	struct member_pointer_type<Member Class::*> {
+		using type = Member;
+	};
+
+	/**
+	 * T has own @ref boost::json::value_to conversion found by ADL, which @ref parse_json_into doesn't use
+	 */
+	template<typename T>
+	concept custom_json_conversion =
+		requires(const boost::json::value& json) { tag_invoke(boost::json::value_to_tag<T>{}, json); } ||
+		requires(const boost::json::value& json) { tag_invoke(boost::json::try_value_to_tag<T>{}, json); };
+
+	template<typename T>
+	consteval bool is_parse_into_supported();
+
+	template<template<typename ...> typename List, typename ... Descriptors>
+	consteval bool are_members_parse_into_supported(List<Descriptors ...>) {
+		return (is_parse_into_supported<typename member_pointer_type<std::remove_cv_t<decltype(Descriptors::pointer)>>::type>() && ...);
+	}
+
+	/**
+	 * Checks whether T can be filled by @ref parse_json_into and serialized by Boost.JSON without DOM. Neither uses tag_invoke conversions,
+	 * so types like @ref std::chrono::duration and described structs with own conversions go through DOM
+	 * @return Returns true for numbers, strings, vectors, optionals, string-keyed maps and described structs of such members
+	 */
+	template<typename T>
+	consteval bool is_parse_into_supported() {
+		if constexpr (std::is_arithmetic_v<T> || std::same_as<T, std::string>) {
+			return true;
+		}
+		else if constexpr (specialization_of<T, std::optional> || specialization_of<T, std::vector>) {
+			return is_parse_into_supported<typename T::value_type>();
+		}
+		else if constexpr (specialization_of<T, std::map> || specialization_of<T, std::unordered_map>) {
+			return std::same_as<typename T::key_type, std::string> && is_parse_into_supported<typename T::mapped_type>();
+		}
+		else if constexpr (boost::describe::has_describe_members<T>::value) {
+			return !custom_json_conversion<T> && are_members_parse_into_supported(boost::describe::describe_members<T, boost::describe::mod_public | boost::describe::mod_inherited>{});
+		}
+		else {
+			return false;
+		}
+	}
+
+	template<typename T>
+	concept parse_into_supported = is_parse_into_supported<T>();
+
+	/**
+	 * Operations, which fill value of one type from SAX parser events. Operation is nullptr if the type can't take such JSON value
+	 */
+	struct JsonIntoOps {
+		/// Error of JSON value, which the type can't take
+		boost::json::error mismatch;
+		/// Constructs value of optional and returns it with its operations. Set only for optionals
+		void* (*emplace)(void* target, const JsonIntoOps** ops);
+		void (*on_null)(void* target);
+		void (*on_bool)(void* target, const bool value);
+		/// Number operations return false if the number doesn't fit the type exactly
+		bool (*on_int64)(void* target, const int64_t value);
+		bool (*on_uint64)(void* target, const uint64_t value);
+		bool (*on_double)(void* target, const double value);
+		void (*on_string)(void* target, std::string_view value);
+		void (*on_array_begin)(void* target);
+		/// Appends array element and returns it with its operations
+		void* (*next_element)(void* target, const JsonIntoOps** ops);
+		/// Resets filled to track found members of struct
+		void (*on_object_begin)(void* target, std::vector<bool>& filled);
+		/// Returns member of the key with its operations, or nullptr if the type has no such member, so its value is skipped
+		void* (*find_member)(void* target, std::string_view key, std::vector<bool>& filled, const JsonIntoOps** ops);
+		/// Returns false if member, which isn't optional, wasn't found
+		bool (*on_object_end)(const std::vector<bool>& filled);
+	};
+
+	template<typename T>
+	struct JsonInto;
+
+	/**
+	 * Operations of T, see @ref JsonIntoOps
+	 */
+	template<typename T>
+	inline constexpr JsonIntoOps json_into_ops = JsonInto<T>::make_ops();
+
+	/**
+	 * Makes @ref JsonIntoOps of type, which is @ref parse_into_supported. Conversions are the same as @ref boost::json::value_to ones
+	 */
+	template<typename T>
+	struct JsonInto {
+		static void* emplace(void* target, const JsonIntoOps** ops) {
+			*ops = &json_into_ops<typename T::value_type>;
+			return &static_cast<T*>(target)->emplace();
+		}
+
+		static void reset(void* target) {
+			static_cast<T*>(target)->reset();
+		}
+
+		static void assign_bool(void* target, const bool value) {
+			*static_cast<T*>(target) = value;
+		}
+
+		template<typename Number>
+		static bool assign_number(void* target, const Number value) {
+			T& result = *static_cast<T*>(target);
+			if constexpr (std::is_floating_point_v<T>) {
+				result = static_cast<T>(value);
+				return true;
+			}
+			else if constexpr (std::is_floating_point_v<Number>) {
+				// double fits if it's integral and in the range, which bounds are powers of two, so they're exact
+				const double bound = std::ldexp(1.0, std::numeric_limits<T>::digits);
+				const double min = std::is_signed_v<T> ? -bound : 0.0;
+				if (std::trunc(value) != value || value < min || value >= bound) {
+					return false;
+				}
+				result = static_cast<T>(value);
+				return true;
+			}
+			else {
+				using Limits = std::numeric_limits<T>;
+				const bool fits = (std::is_signed_v<Number> && value < 0) ?
+					std::is_signed_v<T> && static_cast<int64_t>(value) >= static_cast<int64_t>(Limits::min()) :
+					static_cast<uint64_t>(value) <= static_cast<uint64_t>(Limits::max());
+				if (!fits) {
+					return false;
+				}
+				result = static_cast<T>(value);
+				return true;
+			}
+		}
+
+		static void assign_string(void* target, std::string_view value) {
+			static_cast<T*>(target)->assign(value);
+		}
+
+		static void clear(void* target) {
+			static_cast<T*>(target)->clear();
+		}
+
+		static void* next_element(void* target, const JsonIntoOps** ops) {
+			*ops = &json_into_ops<typename T::value_type>;
+			return &static_cast<T*>(target)->emplace_back();
+		}
+
+		static void clear_map(void* target, std::vector<bool>&) {
+			static_cast<T*>(target)->clear();
+		}
+
+		static void* find_entry(void* target, std::string_view key, std::vector<bool>&, const JsonIntoOps** ops) {
+			*ops = &json_into_ops<typename T::mapped_type>;
+			// the last of duplicate keys wins like in DOM
+			auto& value = (*static_cast<T*>(target))[std::string(key)];
+			value = typename T::mapped_type{};
+			return &value;
+		}
+
+		static bool end_map(const std::vector<bool>&) {
+			return true;
+		}
+
+		static void begin_struct(void*, std::vector<bool>& filled) {
+			using Members = boost::describe::describe_members<T, boost::describe::mod_public | boost::describe::mod_inherited>;
+			filled.assign(boost::mp11::mp_size<Members>::value, false);
+		}
+
+		static void* find_member(void* target, std::string_view key, std::vector<bool>& filled, const JsonIntoOps** ops) {
+			using Members = boost::describe::describe_members<T, boost::describe::mod_public | boost::describe::mod_inherited>;
+			void* member = nullptr;
+			size_t index = 0;
+			boost::mp11::mp_for_each<Members>([&](auto descriptor) {
+				using Member = typename member_pointer_type<std::remove_cv_t<decltype(descriptor.pointer)>>::type;
+				if (!member && key == descriptor.name) {
+					auto& value = static_cast<T*>(target)->*descriptor.pointer;
+					value = Member{};
+					member = &value;
+					*ops = &json_into_ops<Member>;
+					filled[index] = true;
+				}
+				index++;
+			});
+			return member;
+		}
+
+		static bool end_struct(const std::vector<bool>& filled) {
+			using Members = boost::describe::describe_members<T, boost::describe::mod_public | boost::describe::mod_inherited>;
+			bool has_required = true;
+			size_t index = 0;
+			boost::mp11::mp_for_each<Members>([&](auto descriptor) {
+				using Member = typename member_pointer_type<std::remove_cv_t<decltype(descriptor.pointer)>>::type;
+				if (!specialization_of<Member, std::optional> && !filled[index]) {
+					has_required = false;
+				}
+				index++;
+			});
+			return has_required;
+		}
+
+		static constexpr JsonIntoOps make_ops() {
+			JsonIntoOps ops{};
+			if constexpr (specialization_of<T, std::optional>) {
+				ops.emplace = emplace;
+				ops.on_null = reset;
+			}
+			else if constexpr (std::same_as<T, bool>) {
+				ops.mismatch = boost::json::error::not_bool;
+				ops.on_bool = assign_bool;
+			}
+			else if constexpr (std::is_arithmetic_v<T>) {
+				ops.mismatch = boost::json::error::not_number;
+				ops.on_int64 = assign_number<int64_t>;
+				ops.on_uint64 = assign_number<uint64_t>;
+				ops.on_double = assign_number<double>;
+			}
+			else if constexpr (std::same_as<T, std::string>) {
+				ops.mismatch = boost::json::error::not_string;
+				ops.on_string = assign_string;
+			}
+			else if constexpr (specialization_of<T, std::vector>) {
+				ops.mismatch = boost::json::error::not_array;
+				ops.on_array_begin = clear;
+				ops.next_element = next_element;
+			}
+			else if constexpr (specialization_of<T, std::map> || specialization_of<T, std::unordered_map>) {
+				ops.mismatch = boost::json::error::not_object;
+				ops.on_object_begin = clear_map;
+				ops.find_member = find_entry;
+				ops.on_object_end = end_map;
+			}
+			else {
+				ops.mismatch = boost::json::error::not_object;
+				ops.on_object_begin = begin_struct;
+				ops.find_member = find_member;
+				ops.on_object_end = end_struct;
+			}
+			return ops;
+		}
+	};
+
+	/**
+	 * Fills value in one pass of SAX parser without building DOM. Values of keys, which aren't members, are skipped
+	 * @param from The string to parse
+	 * @param target The value to fill
+	 * @param ops Operations of the value type, see @ref json_into_ops
+	 * @throws @ref boost::system::system_error If parse failed or text doesn't match the type
+	 */
+	extern void parse_json_into(std::string_view from, void* target, const JsonIntoOps& ops);
+
+	template<typename T>
+	consteval bool is_json_storage_free();
+
+	template<template<typename ...> typename List, typename ... Descriptors>
+	consteval bool are_members_json_storage_free(List<Descriptors ...>) {
+		return (is_json_storage_free<typename member_pointer_type<std::remove_cv_t<decltype(Descriptors::pointer)>>::type>() && ...);
+	}
+
+	/**
+	 * Checks whether T converted from DOM keeps no memory of the DOM storage, so the DOM may be freed right after conversion.
+	 * Types holding JSON containers, like @ref boost::json::value, and unknown types are assumed to keep it
+	 * @return Returns true for numbers, strings, chrono types, vectors, optionals, string-keyed maps and described structs of such members
+	 */
+	template<typename T>
+	consteval bool is_json_storage_free() {
+		if constexpr (std::is_arithmetic_v<T> || std::same_as<T, std::string>) {
+			return true;
+		}
+		else if constexpr (specialization_of<T, std::chrono::duration> || specialization_of<T, std::chrono::time_point>) {
+			return true;
+		}
+		else if constexpr (specialization_of<T, std::optional> || specialization_of<T, std::vector>) {
+			return is_json_storage_free<typename T::value_type>();
+		}
+		else if constexpr (specialization_of<T, std::map> || specialization_of<T, std::unordered_map>) {
+			return std::same_as<typename T::key_type, std::string> && is_json_storage_free<typename T::mapped_type>();
+		}
+		else if constexpr (boost::describe::has_describe_members<T>::value) {
+			return are_members_json_storage_free(boost::describe::describe_members<T, boost::describe::mod_public | boost::describe::mod_inherited>{});
+		}
+		else {
+			return false;
+		}
+	}
+
+	template<typename T>
+	concept json_storage_free = is_json_storage_free<T>();
+};
@@ -0,0 +1,376 @@
+#pragma once
+#include <asyncnet/Exceptions.hpp>
+
+#include <curl/curl.h>
+#if defined(__linux__)
+# include <coro/io_scheduler.hpp>
+# include <coro/task.hpp>
+#endif
+
+#include <atomic>
+#include <chrono>
+#include <coroutine>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <queue>
+#include <span>
+#include <stop_token>
+#include <string_view>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace asyncnet::detail {
+
+	class MultiEngine;
+
+	/**
+	 * Transfer timeouts, which curl doesn't provide. Zero means no timeout
+	 */
+	struct TransferTimeouts {
+		std::chrono::milliseconds first_byte{};
+		std::chrono::milliseconds idle{};
+	};
+
+	/**
+	 * Collects indexes of done transfers of one batch. Producers push completions and then flush them,
+	 * so the waiting coroutine is resumed once for all transfers done by one loop iteration
+	 */
+	class CompletionQueue : public std::enable_shared_from_this<CompletionQueue> {
+	public:
+		class WaitAwaitable {
+		public:
+			explicit WaitAwaitable(CompletionQueue& queue) noexcept;
+
+			bool await_ready() const;
+
+			bool await_suspend(std::coroutine_handle<> coroutine);
+
+			/**
+			 * @return Returns indexes of transfers done since the previous wait in completion order
+			 */
+			std::vector<size_t> await_resume();
+
+		private:
+			CompletionQueue& queue_;
+		};
+
+		/**
+		 * @param expected Count of transfers in the batch
+		 */
+		explicit CompletionQueue(const size_t expected);
+
+		/**
+		 * Thread safe records done transfer without resuming the waiting coroutine
+		 * @param index Index of transfer in the batch
+		 */
+		void push(const size_t index);
+
+		/**
+		 * Thread safe resumes the waiting coroutine on the calling thread, if there are recorded transfers
+		 */
+		void flush();
+
+		/**
+		 * Waits for done transfers. Only one coroutine can wait at once
+		 * @return Returns awaitable, which results in indexes of done transfers
+		 */
+		WaitAwaitable wait() noexcept;
+
+		/**
+		 * Keeps the owner of transfers alive until every transfer of the batch is pushed, so abandoned batch can finish in the loop
+		 * @param owner Owner of transfers
+		 */
+		void keep_alive(std::shared_ptr<void> owner);
+
+		/**
+		 * @return Returns count of transfers in the batch
+		 */
+		size_t expected() const noexcept;
+
+	private:
+		std::mutex mutex_;
+		std::vector<size_t> done_;
+		std::coroutine_handle<> waiter_ = nullptr;
+		const size_t expected_;
+		size_t pushed_ = 0;
+		std::shared_ptr<void> owner_;
+	};
+
+	/**
+	 * Result of transfer performed by @ref MultiEngine
+	 */
+	struct TransferResult {
+		CURLcode code = CURLE_OK;
+		/// Set if a timeout checked by the loop expired. Code is @ref TimeoutErrorCode then
+		std::optional<TimeoutKind> expired_timeout;
+	};
+
+	/**
+	 * Single transfer submitted to @ref MultiEngine. Lives inside the awaiting coroutine frame or in the batch
+	 */
+	struct Transfer {
+		CURL* easy = nullptr;
+		TransferResult result;
+		std::coroutine_handle<> continuation = nullptr;
+		TransferTimeouts timeouts;
+		/// If set, done transfer is pushed to the queue instead of resuming continuation
+		CompletionQueue* completions = nullptr;
+		size_t index = 0;
+
+		// accessed only from loop thread
+		std::chrono::steady_clock::time_point started;
+		std::chrono::steady_clock::time_point last_activity;
+		curl_off_t transferred_bytes = 0;
+		bool first_byte_pending = false;
+
+		// guarded by the engine submit mutex
+		uint64_t id = 0;
+		bool submitted = false;
+		bool cancelled = false;
+	};
+
+	/**
+	 * Event loop thread which drives many transfers at once with curl_multi_socket_action.
+	 * On Linux sockets are polled with epoll, elsewhere the loop falls back to curl_multi_poll.
+	 * On Linux the loop can also run as a task of coro::io_scheduler instead of own thread, see @ref MultiEngine::make_shared
+	 */
+	class MultiEngine {
+	public:
+		class PerformAwaitable {
+		public:
+			explicit PerformAwaitable(MultiEngine& engine, CURL* easy, std::stop_token stop_token, const TransferTimeouts& timeouts) noexcept;
+
+			// engine and stop callback keep pointer to the transfer
+			PerformAwaitable(const PerformAwaitable& other) = delete;
+			PerformAwaitable(PerformAwaitable&& other) = delete;
+
+			bool await_ready() const noexcept;
+
+			bool await_suspend(std::coroutine_handle<> coroutine);
+
+			TransferResult await_resume() const noexcept;
+
+		private:
+			struct Canceller {
+				void operator()() const noexcept;
+
+				MultiEngine* engine;
+				Transfer* transfer;
+			};
+
+			MultiEngine& engine_;
+			Transfer transfer_;
+			std::stop_token stop_token_;
+			std::optional<std::stop_callback<Canceller>> stop_callback_;
+		};
+
+		/**
+		 * Starts own loop thread
+		 * @param cpu CPU core to pin the loop thread to. Pinning is supported only on Linux, elsewhere it's ignored
+		 */
+		explicit MultiEngine(const std::optional<unsigned>& cpu = std::nullopt);
+		MultiEngine(const MultiEngine& other) = delete;
+		MultiEngine(MultiEngine&& other) = delete;
+		~MultiEngine();
+
+#if defined(__linux__)
+		/**
+		 * Creates the loop, which runs as scheduler task without own thread. Transfers are resumed on the scheduler thread.
+		 * The task keeps the engine alive until @ref stop is called, the scheduler must not be shut down before it
+		 * @param scheduler The scheduler to poll sockets and run the loop
+		 * @return Returns started engine
+		 */
+		static std::shared_ptr<MultiEngine> make_shared(std::shared_ptr<coro::io_scheduler> scheduler);
+#endif
+
+		/**
+		 * Adds easy handle to the loop. The awaiting coroutine is resumed on the loop thread when transfer is done.
+		 * When stop is requested, the transfer is removed from the loop at once and results in CURLE_ABORTED_BY_CALLBACK
+		 * @param easy The handle to perform. Must stay alive until the transfer is done
+		 * @param stop_token Token to cancel the transfer
+		 * @param timeouts Timeouts checked by the loop. Expired transfer results in @ref TimeoutKind::FirstByte or @ref TimeoutKind::Idle
+		 * @return Returns awaitable, which results in @ref TransferResult
+		 */
+		PerformAwaitable perform(CURL* easy, std::stop_token stop_token = {}, const TransferTimeouts& timeouts = {}) noexcept;
+
+		/**
+		 * Thread safe queues transfer and wakes the loop
+		 * @param transfer Transfer to add
+		 * @return Returns false if transfer was cancelled before submitting, otherwise true
+		 */
+		bool submit(Transfer* transfer);
+
+		/**
+		 * Thread safe queues transfers of one batch under one lock and wakes the loop once.
+		 * Transfers must have @ref Transfer::completions set and can't be cancelled before submitting
+		 * @param transfers Transfers to add
+		 */
+		void submit(std::span<Transfer* const> transfers);
+
+		/**
+		 * Thread safe continues transfer paused by CURL_WRITEFUNC_PAUSE. Transfer, which is already done, is skipped
+		 * @param id Id of the paused transfer, see @ref Transfer::id
+		 */
+		void unpause(const uint64_t id);
+
+		/**
+		 * Resumes the coroutine on the loop thread after the current iteration, so it doesn't run inside curl callbacks.
+		 * Must be called only on the loop thread
+		 * @param coroutine Coroutine to resume
+		 */
+		void defer(std::coroutine_handle<> coroutine);
+
+		/**
+		 * Thread safe removes transfer from the loop. If transfer isn't submitted yet, it won't be submitted
+		 * @param transfer Transfer to remove. Must be alive during the call
+		 */
+		void cancel(Transfer* transfer);
+
+		/**
+		 * Thread safe queues multi handle configuration. It's applied on the loop thread before adding next transfers
+		 * @param configure Function to call with the multi handle
+		 */
+		void configure(std::function<void(CURLM*)> configure);
+
+		/**
+		 * @return Returns count of transfers, which are submitted but not done yet
+		 */
+		size_t active_count() const noexcept;
+
+		/**
+		 * Thread safe stops the loop. Transfers, which aren't done yet, result in CURLE_ABORTED_BY_CALLBACK
+		 */
+		void stop();
+
+	private:
+		static int socket_callback(CURL* easy, curl_socket_t socket, int what, void* userp, void* socketp);
+		static int timer_callback(CURLM* multi, long timeout_ms, void* userp);
+
+		void initialize();
+		void run();
+		void wake();
+#if defined(__linux__)
+		explicit MultiEngine(std::shared_ptr<coro::io_scheduler> scheduler);
+
+		static coro::task<void> drive(std::shared_ptr<MultiEngine> engine);
+		void run_once(const int timeout_ms);
+#endif
+		using Deadline = std::pair<std::chrono::steady_clock::time_point, uint64_t>;
+
+		int wait_timeout_ms() const;
+		void process_commands();
+		void check_completions();
+		void check_deadlines();
+		void schedule_deadline(Transfer* transfer, std::chrono::steady_clock::time_point now);
+		std::optional<TimeoutKind> expired_timeout(Transfer* transfer, std::chrono::steady_clock::time_point now) const;
+		void complete(Transfer* transfer, CURLcode code);
+		void complete_all(CURLcode code);
+		void flush_completions();
+
+		CURLM* multi_;
+		std::atomic<bool> stopping_ = false;
+		std::atomic<size_t> active_count_ = 0;
+
+		std::mutex submit_mutex_;
+		std::vector<Transfer*> submitted_;
+		std::vector<uint64_t> cancelled_;
+		std::vector<uint64_t> unpaused_;
+		std::vector<std::function<void(CURLM*)>> configurations_;
+		uint64_t next_id_ = 1;
+
+		// accessed only from loop thread
+		std::unordered_map<uint64_t, Transfer*> running_;
+		std::priority_queue<Deadline, std::vector<Deadline>, std::greater<Deadline>> deadlines_;
+		long timeout_ms_ = -1;
+		std::chrono::steady_clock::time_point timer_deadline_;
+		/// Batches, which got done transfers in the current iteration
+		std::vector<std::shared_ptr<CompletionQueue>> pending_completions_;
+		/// Coroutines to resume after the current iteration
+		std::vector<std::coroutine_handle<>> deferred_;
+
+#if defined(__linux__)
+		int epoll_fd_ = -1;
+		int wake_fd_ = -1;
+		std::shared_ptr<coro::io_scheduler> scheduler_;
+#endif
+		std::thread thread_;
+	};
+
+	/**
+	 * Fixed set of @ref MultiEngine loops. Transfers are spread between loops in round robin order,
+	 * or in sharded mode routed by origin hash, so connections of one origin stay warm in one loop
+	 */
+	class EngineGroup {
+	public:
+		/**
+		 * Starts loop_count event loops
+		 * @param loop_count Count of event loops (threads)
+		 * @param sharded Set to true to pin every loop to its own CPU core and route transfers by origin
+		 */
+		explicit EngineGroup(const unsigned loop_count, const bool sharded = false);
+
+#if defined(__linux__)
+		/**
+		 * Starts one event loop on the scheduler
+		 * @param scheduler The scheduler to run the loop
+		 */
+		explicit EngineGroup(std::shared_ptr<coro::io_scheduler> scheduler);
+#endif
+
+		EngineGroup(const EngineGroup& other) = delete;
+		EngineGroup(EngineGroup&& other) = delete;
+		~EngineGroup();
+
+		/**
+		 * @return Returns the next loop to submit transfer to
+		 */
+		MultiEngine& pick() noexcept;
+
+		/**
+		 * Picks the loop of the origin in sharded mode, otherwise the next loop.
+		 * If work stealing is enabled and the origin loop is busy, picks an idle loop if any.
+		 * Stolen transfer uses connection cache of the multi handle of the loop, which performs it
+		 * @param origin Origin of transfer URL, see @ref url_origin
+		 * @return Returns the loop to submit transfer to
+		 */
+		MultiEngine& pick(std::string_view origin) noexcept;
+
+		/**
+		 * @param origin Origin of transfer URL, see @ref url_origin
+		 * @return Returns loops, which keep connections of the origin: the origin loop in sharded mode, otherwise every loop
+		 */
+		std::vector<MultiEngine*> origin_engines(std::string_view origin) const;
+
+		/**
+		 * Thread safe enables work stealing in sharded mode
+		 * @param threshold Count of active transfers, starting from which the origin loop gives transfers to idle loops. If @ref std::nullopt, stealing is disabled
+		 */
+		void set_work_stealing(const std::optional<size_t>& threshold) noexcept;
+
+		/**
+		 * @return Returns true if transfers are routed by origin
+		 */
+		bool is_sharded() const noexcept;
+
+		/**
+		 * Queues configuration for every loop, see @ref MultiEngine::configure
+		 * @param configure Function to call with the multi handle
+		 */
+		void configure(const std::function<void(CURLM*)>& configure);
+
+	private:
+		static constexpr size_t no_stealing = std::numeric_limits<size_t>::max();
+
+		MultiEngine& home_engine(std::string_view origin) const noexcept;
+
+		std::vector<std::shared_ptr<MultiEngine>> engines_;
+		std::atomic<size_t> next_ = 0;
+		bool sharded_ = false;
+		std::atomic<size_t> steal_threshold_ = no_stealing;
+	};
+}
@@ -0,0 +1,47 @@
+#pragma once
+#include <curlpp/Option.hpp>
+#include <curlpp/internal/CurlHandle.hpp>
+#include <memory>
+#include <string>
+
+namespace asyncnet::detail::options {
+	/// Wait for connection to multiplex on instead of making a new one
+	using PipeWait = curlpp::OptionTrait<long, CURLOPT_PIPEWAIT>;
+
+	/// Custom request target, like "*" for "OPTIONS *"
+	using RequestTarget = curlpp::OptionTrait<std::string, CURLOPT_REQUEST_TARGET>;
+
+	/// Timeout of the whole request in milliseconds
+	using TimeoutMs = curlpp::OptionTrait<long, CURLOPT_TIMEOUT_MS>;
+
+	/// Timeout of the connection phase in milliseconds
+	using ConnectTimeoutMs = curlpp::OptionTrait<long, CURLOPT_CONNECTTIMEOUT_MS>;
+
+	/// Time to wait for "100 Continue" before sending request body in milliseconds
+	using Expect100TimeoutMs = curlpp::OptionTrait<long, CURLOPT_EXPECT_100_TIMEOUT_MS>;
+
+	/**
+	 * Request body, which is shared by copies of the option instead of being copied into every handle.
+	 * Curl doesn't copy it either, so the body lives as long as any request or handle, which has the option
+	 */
+	class SharedPostFields : public curlpp::Option<std::shared_ptr<const std::string>> {
+	public:
+		static constexpr CURLoption option = CURLOPT_POSTFIELDS;
+
+		SharedPostFields() : Option(option) {
+
+		}
+
+		explicit SharedPostFields(const std::shared_ptr<const std::string>& body) : Option(option, body) {
+
+		}
+
+		SharedPostFields* clone() const override {
+			return new SharedPostFields(getValue());
+		}
+
+		void updateHandleToMe(curlpp::internal::CurlHandle* handle) const override {
+			handle->option(option, getValue()->data());
+		}
+	};
+}
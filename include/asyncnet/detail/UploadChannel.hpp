@@ -0,0 +1,108 @@
+#pragma once
+#include <asyncnet/NetTypes.hpp>
+#include <asyncnet/detail/CancellableSchedule.hpp>
+#include <asyncnet/detail/MultiEngine.hpp>
+
+#include <condition_variable>
+#include <coroutine>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+
+namespace asyncnet::detail {
+
+	/**
+	 * Bounded buffer of request body chunks between producing coroutine and running transfer.
+	 * When the buffer is empty, transfer driven by @ref MultiEngine is paused with CURL_READFUNC_PAUSE and continued when the producer adds a chunk.
+	 * Blocking transfer waits for the producer on its worker thread instead. The producer is resumed when the buffer has free space
+	 */
+	class UploadChannel : public std::enable_shared_from_this<UploadChannel> {
+	public:
+		/// Default count of buffered bytes, above which the producer waits for the transfer
+		static constexpr size_t default_buffer_size = 1024 * 1024;
+
+		class SpaceAwaitable {
+		public:
+			explicit SpaceAwaitable(UploadChannel& channel) noexcept;
+
+			bool await_ready() const;
+
+			bool await_suspend(std::coroutine_handle<> coroutine);
+
+			/**
+			 * @return Returns false if the channel is cancelled
+			 */
+			bool await_resume() const;
+
+		private:
+			UploadChannel& channel_;
+		};
+
+		/**
+		 * @param source Producer of body chunks
+		 * @param max_buffered Count of bytes, above which the producer waits
+		 */
+		explicit UploadChannel(BodySource source, const size_t max_buffered = default_buffer_size);
+		UploadChannel(const UploadChannel& other) = delete;
+		UploadChannel(UploadChannel&& other) = delete;
+
+		/**
+		 * Drives the channel by the event loop: empty buffer pauses transfer and producer is resumed after the loop iteration.
+		 * Must be called before @ref start
+		 * @param engine The loop, which performs the transfer
+		 */
+		void attach(MultiEngine* engine) noexcept;
+
+		/**
+		 * Starts producing chunks on the calling thread
+		 */
+		void start();
+
+		/**
+		 * Curl read callback
+		 * @param easy The transfer handle
+		 * @param buffer Buffer to fill
+		 * @param size Size of buffer
+		 * @return Returns count of written bytes, 0 at the end of body, CURL_READFUNC_PAUSE if the transfer must be paused or CURL_READFUNC_ABORT if failed
+		 */
+		size_t read(CURL* easy, char* buffer, const size_t size);
+
+		/**
+		 * Thread safe stops producing. Blocked reader is woken and the next reads fail
+		 */
+		void cancel() noexcept;
+
+		/**
+		 * @return Returns exception of the producer, nullptr if none
+		 */
+		std::exception_ptr error() const;
+
+	private:
+		static DetachedTask pump(std::shared_ptr<UploadChannel> channel);
+
+		SpaceAwaitable space() noexcept;
+		void push(std::string chunk);
+		void finish(std::exception_ptr error);
+		void unpause(std::optional<uint64_t> paused_id);
+
+		BodySource source_;
+		mutable std::mutex mutex_;
+		std::condition_variable data_;
+		std::deque<std::string> chunks_;
+		/// Count of bytes of the first chunk, which are already read
+		size_t offset_ = 0;
+		size_t buffered_ = 0;
+		const size_t max_buffered_;
+		std::coroutine_handle<> waiter_ = nullptr;
+		MultiEngine* engine_ = nullptr;
+		/// Id of the paused event loop transfer
+		std::optional<uint64_t> paused_id_;
+		bool finished_ = false;
+		bool cancelled_ = false;
+		std::exception_ptr error_;
+	};
+}
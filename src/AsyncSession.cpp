@@ -1,21 +1,33 @@
 #include <asyncnet/AsyncSession.hpp>
 #include <asyncnet/detail/Format.hpp>
 
+#include <algorithm>
 #include <sstream>
+#include <variant>
+#include <coro/when_all.hpp>
 #include <curlpp/Options.hpp>
 #include <curlpp/Infos.hpp>
 
 namespace asyncnet {
-	AsyncSession::AsyncSession(unsigned worker_count) : Requestor(worker_count) {
+	AsyncSession::AsyncSession(unsigned worker_count, const RequestorEngine engine) : Requestor(worker_count, engine) {
 		initialize_handle();
 	}
 
+#if defined(__linux__)
+	AsyncSession::AsyncSession(std::shared_ptr<coro::io_scheduler> scheduler) : Requestor(std::move(scheduler)) {
+		initialize_handle();
+	}
+#endif
+
 	AsyncSession::AsyncSession(Requestor&& requestor) : Requestor(std::move(requestor)) {
 		initialize_handle();
 	}
 
 	void AsyncSession::initialize_handle() {
 		set_cookie_file(std::string(Request::cookie_memory));
+		if (!get_connection_pool()) {
+			set_connection_pool(std::make_shared<ConnectionPool>());
+		}
 	}
 
 	void AsyncSession::set_max_redirects(const std::optional<long>& max_redirects) {
@@ -30,6 +42,26 @@ namespace asyncnet {
 		base_request_.set_timeout(timeout);
 	}
 
+	void AsyncSession::set_connect_timeout(const std::optional<std::chrono::system_clock::duration>& timeout) {
+		base_request_.set_connect_timeout(timeout);
+	}
+
+	void AsyncSession::set_first_byte_timeout(const std::optional<std::chrono::system_clock::duration>& timeout) {
+		base_request_.set_first_byte_timeout(timeout);
+	}
+
+	void AsyncSession::set_idle_timeout(const std::optional<std::chrono::system_clock::duration>& timeout) {
+		base_request_.set_idle_timeout(timeout);
+	}
+
+	void AsyncSession::set_priority(const RequestPriority priority) {
+		base_request_.set_priority(priority);
+	}
+
+	void AsyncSession::set_tenant(const std::string& tenant) {
+		base_request_.set_tenant(tenant);
+	}
+
 	void AsyncSession::set_default_headers(const std::list<std::string>& headers) {
 		default_headers_ = headers;
 		base_request_.set_headers(default_headers_);
@@ -44,4 +76,67 @@ namespace asyncnet {
 		base_request_.set_cookie_file(filename);
 	}
 
+	void AsyncSession::set_http_version(const HttpVersion& version) {
+		base_request_.set_http_version(version);
+	}
+
+	void AsyncSession::set_keep_alive(const ConnectionPool::Options& options) {
+		set_connection_pool(std::make_shared<ConnectionPool>(options));
+	}
+
+	void AsyncSession::set_concurrency_limits(const ConcurrencyLimiter::Options& options) {
+		set_concurrency_limiter(std::make_shared<ConcurrencyLimiter>(options));
+	}
+
+
+	coro::task<std::vector<WarmUpResult>> AsyncSession::warm_up(std::vector<std::string> origins, const unsigned connections_per_origin) {
+		using std::chrono::microseconds;
+		using Connection = std::variant<Response, std::exception_ptr>;
+
+		auto connect = [](NetworkTask task) -> coro::task<Connection> {
+			try {
+				co_return co_await std::move(task);
+			}
+			catch (...) {
+				co_return std::current_exception();
+			}
+		};
+
+		// every loop or worker keeps its own connections, so each one is warmed up
+		std::vector<coro::task<Connection>> tasks;
+		std::vector<size_t> task_origins;
+		for (size_t i = 0; i < origins.size(); i++) {
+			for (auto& task : perform_per_owner(WarmUpRequest(base_request_, origins[i]), connections_per_origin)) {
+				tasks.push_back(connect(std::move(task)));
+				task_origins.push_back(i);
+			}
+		}
+
+		auto connections = co_await coro::when_all(std::move(tasks));
+
+		std::vector<WarmUpResult> results(origins.size());
+		for (size_t i = 0; i < connections.size(); i++) {
+			WarmUpResult& result = results[task_origins[i]];
+			const Connection& connection = connections[i].return_value();
+
+			if (const auto* error = std::get_if<std::exception_ptr>(&connection)) {
+				if (!result.error) {
+					result.error = *error;
+				}
+				continue;
+			}
+
+			const Response& response = std::get<Response>(connection);
+			result.connections++;
+			result.name_lookup_time = std::max(result.name_lookup_time, microseconds(response.get_info<curl_off_t>(CURLINFO_NAMELOOKUP_TIME_T)));
+			result.connect_time = std::max(result.connect_time, microseconds(response.get_info<curl_off_t>(CURLINFO_CONNECT_TIME_T)));
+			result.tls_time = std::max(result.tls_time, microseconds(response.get_info<curl_off_t>(CURLINFO_APPCONNECT_TIME_T)));
+			result.total_time = std::max(result.total_time, microseconds(response.get_info<curl_off_t>(CURLINFO_TOTAL_TIME_T)));
+		}
+
+		for (size_t i = 0; i < origins.size(); i++) {
+			results[i].origin = std::move(origins[i]);
+		}
+		co_return results;
+	}
 };
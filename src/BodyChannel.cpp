@@ -0,0 +1,171 @@
+#include <asyncnet/detail/BodyChannel.hpp>
+#include <asyncnet/Exceptions.hpp>
+
+#include <utility>
+
+namespace asyncnet::detail {
+
+	BodyChannel::ReadAwaitable::ReadAwaitable(BodyChannel& channel) noexcept : channel_(channel) {
+
+	}
+
+	bool BodyChannel::ReadAwaitable::await_ready() const {
+		std::lock_guard lock(channel_.mutex_);
+		return !channel_.chunks_.empty() || channel_.closed_;
+	}
+
+	bool BodyChannel::ReadAwaitable::await_suspend(std::coroutine_handle<> coroutine) {
+		std::lock_guard lock(channel_.mutex_);
+		if (!channel_.chunks_.empty() || channel_.closed_) {
+			return false;
+		}
+		channel_.waiter_ = coroutine;
+		return true;
+	}
+
+	std::optional<std::string> BodyChannel::ReadAwaitable::await_resume() {
+		return channel_.take();
+	}
+
+	BodyChannel::BodyChannel(const size_t max_buffered) : max_buffered_(max_buffered) {
+
+	}
+
+	void BodyChannel::attach(MultiEngine* engine) noexcept {
+		engine_ = engine;
+	}
+
+	size_t BodyChannel::write(CURL* easy, const char* data, const size_t size) {
+		std::coroutine_handle<> waiter;
+		{
+			std::unique_lock lock(mutex_);
+			if (status_code_ == 0) {
+				curl_easy_getinfo(easy, CURLINFO_RESPONSE_CODE, &status_code_);
+			}
+
+			// single chunk is accepted into empty buffer, so any chunk size makes progress
+			const auto is_full = [this, size] {
+				return buffered_ != 0 && buffered_ + size > max_buffered_;
+			};
+			if (!cancelled_ && is_full()) {
+				if (engine_) {
+					// curl passes the same data again after unpause
+					char* transfer = nullptr;
+					curl_easy_getinfo(easy, CURLINFO_PRIVATE, &transfer);
+					paused_id_ = reinterpret_cast<Transfer*>(transfer)->id;
+					return CURL_WRITEFUNC_PAUSE;
+				}
+				space_.wait(lock, [this, &is_full] {
+					return cancelled_ || !is_full();
+				});
+			}
+
+			if (cancelled_) {
+				// curl fails the transfer, when less than size is written
+				return 0;
+			}
+
+			chunks_.emplace_back(data, size);
+			buffered_ += size;
+			waiter = std::exchange(waiter_, nullptr);
+		}
+
+		if (!waiter) {
+			return size;
+		}
+
+		// user code must not run inside the loop callbacks
+		if (engine_) {
+			engine_->defer(waiter);
+		}
+		else {
+			waiter.resume();
+		}
+		return size;
+	}
+
+	void BodyChannel::close(std::exception_ptr error, const long status_code) noexcept {
+		std::coroutine_handle<> waiter;
+		{
+			std::lock_guard lock(mutex_);
+			closed_ = true;
+			if (status_code_ == 0) {
+				status_code_ = status_code;
+			}
+			paused_id_.reset();
+			// transfer stopped by the channel fails with write error
+			error_ = error && cancelled_ ? std::make_exception_ptr(NetworkRuntimeError(curl_easy_strerror(CancelledErrorCode), CancelledErrorCode)) : error;
+			waiter = std::exchange(waiter_, nullptr);
+		}
+
+		if (waiter) {
+			waiter.resume();
+		}
+	}
+
+	void BodyChannel::set_stop_source(std::stop_source stop_source) {
+		{
+			std::lock_guard lock(mutex_);
+			if (!cancelled_) {
+				stop_source_ = std::move(stop_source);
+				return;
+			}
+		}
+		stop_source.request_stop();
+	}
+
+	void BodyChannel::cancel() noexcept {
+		std::stop_source stop_source{ std::nostopstate };
+		{
+			std::lock_guard lock(mutex_);
+			if (cancelled_ || closed_) {
+				return;
+			}
+			cancelled_ = true;
+			paused_id_.reset();
+			stop_source = stop_source_;
+		}
+		space_.notify_all();
+
+		// stop callbacks may resume the transfer coroutine, so the lock is released
+		stop_source.request_stop();
+	}
+
+	BodyChannel::ReadAwaitable BodyChannel::read() noexcept {
+		return ReadAwaitable(*this);
+	}
+
+	long BodyChannel::status_code() const {
+		std::lock_guard lock(mutex_);
+		return status_code_;
+	}
+
+	std::optional<std::string> BodyChannel::take() {
+		std::optional<std::string> chunk;
+		std::optional<uint64_t> unpause_id;
+		{
+			std::lock_guard lock(mutex_);
+			if (chunks_.empty()) {
+				if (error_) {
+					std::rethrow_exception(error_);
+				}
+				return std::nullopt;
+			}
+
+			chunk = std::move(chunks_.front());
+			chunks_.pop_front();
+			buffered_ -= chunk->size();
+
+			// continuing at a half of the buffer avoids pause on every chunk
+			if (paused_id_ && buffered_ <= max_buffered_ / 2) {
+				unpause_id = std::exchange(paused_id_, std::nullopt);
+			}
+		}
+
+		space_.notify_one();
+		if (unpause_id) {
+			engine_->unpause(*unpause_id);
+		}
+		return chunk;
+	}
+}
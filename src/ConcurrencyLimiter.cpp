@@ -0,0 +1,353 @@
+#include <asyncnet/ConcurrencyLimiter.hpp>
+
+#include <algorithm>
+#include <utility>
+
+namespace asyncnet {
+
+	ConcurrencyLimiter::Permit::Permit(ConcurrencyLimiter* limiter, HostState* host, const RequestPriority priority) noexcept :
+		limiter_(limiter),
+		host_(host),
+		priority_(priority)
+	{
+
+	}
+
+	ConcurrencyLimiter::Permit::Permit(Permit&& other) noexcept :
+		limiter_(std::exchange(other.limiter_, nullptr)),
+		host_(std::exchange(other.host_, nullptr)),
+		priority_(other.priority_)
+	{
+
+	}
+
+	ConcurrencyLimiter::Permit& ConcurrencyLimiter::Permit::operator=(Permit&& other) noexcept {
+		if (this != &other) {
+			release();
+			limiter_ = std::exchange(other.limiter_, nullptr);
+			host_ = std::exchange(other.host_, nullptr);
+			priority_ = other.priority_;
+		}
+		return *this;
+	}
+
+	ConcurrencyLimiter::Permit::~Permit() {
+		release();
+	}
+
+	void ConcurrencyLimiter::Permit::release() noexcept {
+		if (!limiter_) {
+			return;
+		}
+
+		std::exchange(limiter_, nullptr)->release(host_, priority_);
+		host_ = nullptr;
+	}
+
+	ConcurrencyLimiter::AcquireAwaitable::AcquireAwaitable(ConcurrencyLimiter& limiter, std::string_view origin, const RequestPriority priority, std::string_view tenant, std::stop_token stop_token) :
+		limiter_(limiter),
+		origin_(origin),
+		tenant_(tenant),
+		waiter_{ .priority = priority },
+		stop_token_(std::move(stop_token))
+	{
+
+	}
+
+	bool ConcurrencyLimiter::AcquireAwaitable::await_ready() const noexcept {
+		return false;
+	}
+
+	bool ConcurrencyLimiter::AcquireAwaitable::await_suspend(std::coroutine_handle<> coroutine) {
+		waiter_.continuation = coroutine;
+
+		// registered before enqueueing, so the stop can't be missed. If stop is already requested, waiter won't be enqueued
+		stop_callback_.emplace(stop_token_, Canceller{ &limiter_, &waiter_ });
+
+		// the slot may be already given on another thread, don't touch members after enqueueing
+		return limiter_.try_enqueue(&waiter_, origin_, tenant_);
+	}
+
+	std::optional<ConcurrencyLimiter::Permit> ConcurrencyLimiter::AcquireAwaitable::await_resume() noexcept {
+		if (!waiter_.granted) {
+			return std::nullopt;
+		}
+		return Permit(&limiter_, waiter_.host, waiter_.priority);
+	}
+
+	void ConcurrencyLimiter::AcquireAwaitable::Canceller::operator()() const noexcept {
+		limiter->cancel(waiter);
+	}
+
+	ConcurrencyLimiter::ConcurrencyLimiter(const Options& options) : options_(options) {
+
+	}
+
+	ConcurrencyLimiter::~ConcurrencyLimiter() = default;
+
+	ConcurrencyLimiter::AcquireAwaitable ConcurrencyLimiter::acquire(std::string_view origin, const RequestPriority priority, std::string_view tenant, std::stop_token stop_token) {
+		return AcquireAwaitable(*this, origin, priority, tenant, std::move(stop_token));
+	}
+
+	size_t ConcurrencyLimiter::in_flight() const {
+		std::lock_guard lock(mutex_);
+		return in_flight_;
+	}
+
+	size_t ConcurrencyLimiter::in_flight(const RequestPriority priority) const {
+		std::lock_guard lock(mutex_);
+		return priority_in_flight_[static_cast<size_t>(priority)];
+	}
+
+	size_t ConcurrencyLimiter::queued() const {
+		std::lock_guard lock(mutex_);
+		return queued_;
+	}
+
+	ConcurrencyLimiter::Options ConcurrencyLimiter::options() const {
+		std::lock_guard lock(mutex_);
+		return options_;
+	}
+
+	void ConcurrencyLimiter::set_priority_limit(const RequestPriority priority, const std::optional<size_t>& max_in_flight) {
+		std::vector<Waiter*> granted;
+		{
+			std::lock_guard lock(mutex_);
+			options_.max_in_flight_per_priority[static_cast<size_t>(priority)] = max_in_flight;
+			granted = dispatch();
+		}
+
+		for (Waiter* waiter : granted) {
+			waiter->continuation.resume();
+		}
+	}
+
+	void ConcurrencyLimiter::set_tenant_weight(const std::string& tenant, const unsigned weight) {
+		std::lock_guard lock(mutex_);
+		options_.tenant_weights[tenant] = weight;
+
+		auto iter = tenants_.find(tenant);
+		if (iter != tenants_.end()) {
+			iter->second->weight = tenant_weight(tenant);
+		}
+	}
+
+	bool ConcurrencyLimiter::try_enqueue(Waiter* waiter, std::string_view origin, std::string_view tenant) {
+		std::lock_guard lock(mutex_);
+		if (waiter->cancelled) {
+			return false;
+		}
+
+		HostState& host = host_state(origin);
+		waiter->host = &host;
+
+		// if there is a free slot, nobody waits for it
+		const auto priority = static_cast<size_t>(waiter->priority);
+		if (has_capacity() && host_has_capacity(host) && priority_has_capacity(priority)) {
+			host.in_flight++;
+			priority_in_flight_[priority]++;
+			in_flight_++;
+			waiter->granted = true;
+			return false;
+		}
+
+		Queue& waiter_queue = queue(host, priority, tenant);
+		waiter->queue = &waiter_queue;
+		waiter->sequence = next_sequence_++;
+		waiter->position = waiter_queue.waiters.insert(waiter_queue.waiters.end(), waiter);
+		waiter->queued = true;
+		queued_++;
+		update_ready(waiter_queue);
+		return true;
+	}
+
+	void ConcurrencyLimiter::cancel(Waiter* waiter) {
+		{
+			std::lock_guard lock(mutex_);
+			waiter->cancelled = true;
+			if (!waiter->queued) {
+				// not enqueued yet or already granted
+				return;
+			}
+
+			Queue& waiter_queue = *waiter->queue;
+			waiter_queue.waiters.erase(waiter->position);
+			waiter->queued = false;
+			queued_--;
+			update_ready(waiter_queue);
+			erase_if_empty(waiter_queue);
+			erase_if_idle(*waiter->host);
+		}
+		waiter->continuation.resume();
+	}
+
+	void ConcurrencyLimiter::release(HostState* host, const RequestPriority priority) noexcept {
+		std::vector<Waiter*> granted;
+		{
+			std::lock_guard lock(mutex_);
+			host->in_flight--;
+			priority_in_flight_[static_cast<size_t>(priority)]--;
+			in_flight_--;
+			update_host_ready(*host);
+			granted = dispatch();
+			erase_if_idle(*host);
+		}
+
+		for (Waiter* waiter : granted) {
+			waiter->continuation.resume();
+		}
+	}
+
+	ConcurrencyLimiter::HostState& ConcurrencyLimiter::host_state(std::string_view origin) {
+		auto& host = hosts_[std::string(origin)];
+		if (!host) {
+			host = std::make_unique<HostState>();
+			host->origin = origin;
+		}
+		return *host;
+	}
+
+	ConcurrencyLimiter::Queue& ConcurrencyLimiter::queue(HostState& host, const size_t priority, std::string_view tenant) {
+		auto& host_queue = host.queues[{ priority, std::string(tenant) }];
+		if (host_queue) {
+			return *host_queue;
+		}
+
+		auto& tenant_state = tenants_[std::string(tenant)];
+		if (!tenant_state) {
+			tenant_state = std::make_unique<TenantState>();
+			tenant_state->name = tenant;
+			tenant_state->weight = tenant_weight(tenant);
+		}
+		tenant_state->queues_count++;
+
+		host_queue = std::make_unique<Queue>();
+		host_queue->host = &host;
+		host_queue->tenant = tenant_state.get();
+		host_queue->priority = priority;
+		return *host_queue;
+	}
+
+	unsigned ConcurrencyLimiter::tenant_weight(std::string_view tenant) const {
+		auto iter = options_.tenant_weights.find(std::string(tenant));
+		const unsigned weight = iter != options_.tenant_weights.end() ? iter->second : options_.default_tenant_weight;
+		return std::max(weight, 1u);
+	}
+
+	void ConcurrencyLimiter::erase_if_empty(Queue& queue) {
+		if (!queue.waiters.empty()) {
+			return;
+		}
+
+		// empty queue isn't ready, so the tenant has no references to it
+		TenantState* tenant = queue.tenant;
+		HostState* host = queue.host;
+		host->queues.erase({ queue.priority, tenant->name });
+
+		tenant->queues_count--;
+		if (tenant->queues_count == 0) {
+			tenants_.erase(tenant->name);
+		}
+	}
+
+	void ConcurrencyLimiter::erase_if_idle(HostState& host) {
+		if (host.in_flight == 0 && host.queues.empty()) {
+			hosts_.erase(host.origin);
+		}
+	}
+
+	bool ConcurrencyLimiter::has_capacity() const noexcept {
+		return !options_.max_in_flight || in_flight_ < *options_.max_in_flight;
+	}
+
+	bool ConcurrencyLimiter::host_has_capacity(const HostState& host) const noexcept {
+		return !options_.max_in_flight_per_host || host.in_flight < *options_.max_in_flight_per_host;
+	}
+
+	bool ConcurrencyLimiter::priority_has_capacity(const size_t priority) const noexcept {
+		const auto& limit = options_.max_in_flight_per_priority[priority];
+		return !limit || priority_in_flight_[priority] < *limit;
+	}
+
+	void ConcurrencyLimiter::update_ready(Queue& queue) {
+		TenantState& tenant = *queue.tenant;
+		auto& ready = tenant.ready[queue.priority];
+
+		if (queue.ready_sequence) {
+			ready.erase({ *queue.ready_sequence, &queue });
+			queue.ready_sequence.reset();
+		}
+		if (!queue.waiters.empty() && host_has_capacity(*queue.host)) {
+			queue.ready_sequence = queue.waiters.front()->sequence;
+			ready.emplace(*queue.ready_sequence, &queue);
+		}
+
+		// tenant takes part in round robin only while it has ready queues
+		auto& round = rounds_[queue.priority];
+		auto& round_position = tenant.round_positions[queue.priority];
+		if (ready.empty() && round_position) {
+			round.erase(*round_position);
+			round_position.reset();
+			tenant.deficits[queue.priority] = 0;
+		}
+		else if (!ready.empty() && !round_position) {
+			round_position = round.insert(round.end(), &tenant);
+		}
+	}
+
+	void ConcurrencyLimiter::update_host_ready(HostState& host) {
+		for (auto& [key, host_queue] : host.queues) {
+			update_ready(*host_queue);
+		}
+	}
+
+	ConcurrencyLimiter::TenantState& ConcurrencyLimiter::next_tenant(const size_t priority) {
+		// the first tenant in round keeps its turn until the deficit is spent
+		TenantState& tenant = *rounds_[priority].front();
+		if (tenant.deficits[priority] == 0) {
+			tenant.deficits[priority] = tenant.weight;
+		}
+		return tenant;
+	}
+
+	std::vector<ConcurrencyLimiter::Waiter*> ConcurrencyLimiter::dispatch() {
+		std::vector<Waiter*> granted;
+		while (has_capacity()) {
+			// the highest priority, which has ready waiter and isn't capped
+			size_t priority = 0;
+			while (priority < request_priority_count && (rounds_[priority].empty() || !priority_has_capacity(priority))) {
+				priority++;
+			}
+			if (priority == request_priority_count) {
+				break;
+			}
+
+			TenantState& tenant = next_tenant(priority);
+			Queue& waiter_queue = *tenant.ready[priority].begin()->second;
+			HostState& host = *waiter_queue.host;
+
+			Waiter* waiter = waiter_queue.waiters.front();
+			waiter_queue.waiters.pop_front();
+			waiter->queued = false;
+			waiter->granted = true;
+			queued_--;
+
+			host.in_flight++;
+			priority_in_flight_[priority]++;
+			in_flight_++;
+
+			// turn passes to the next tenant when the deficit is spent
+			tenant.deficits[priority]--;
+			if (tenant.deficits[priority] == 0) {
+				auto& round = rounds_[priority];
+				round.splice(round.end(), round, round.begin());
+			}
+
+			update_host_ready(host);
+			erase_if_empty(waiter_queue);
+
+			granted.push_back(waiter);
+		}
+		return granted;
+	}
+}
@@ -0,0 +1,227 @@
+#include <asyncnet/ConnectionPool.hpp>
+
+#include <algorithm>
+#include <cctype>
+#include <functional>
+#include <stdexcept>
+
+#if ASYNCNET_HAS_OPENSSL
+# include <openssl/ssl.h>
+#endif
+
+constexpr int curl_continue_resolve = 0;
+constexpr int curl_prereq_ok = 0;
+
+namespace {
+	/// Schemes of connections, which start with TLS handshake
+	constexpr std::array<std::string_view, 7> tls_schemes = { "https", "wss", "ftps", "imaps", "pop3s", "smtps", "ldaps" };
+
+	bool is_tls_scheme(const std::string_view scheme) {
+		// case depends on curl version
+		return std::ranges::any_of(tls_schemes, [scheme](const std::string_view tls_scheme) {
+			return std::ranges::equal(scheme, tls_scheme, [](const unsigned char c, const char tls_c) { return std::tolower(c) == tls_c; });
+		});
+	}
+
+	/**
+	 * @return Returns whether TLS session of the connection is resumed, or @ref std::nullopt if TLS backend doesn't report it
+	 */
+	std::optional<bool> is_tls_session_reused([[maybe_unused]] CURL* easy) {
+#if ASYNCNET_HAS_OPENSSL
+		curl_tlssessioninfo* info = nullptr;
+		if (curl_easy_getinfo(easy, CURLINFO_TLS_SSL_PTR, &info) == CURLE_OK && info && info->backend == CURLSSLBACKEND_OPENSSL && info->internals) {
+			return SSL_session_reused(static_cast<SSL*>(info->internals)) == 1;
+		}
+#endif
+		return std::nullopt;
+	}
+}
+
+namespace asyncnet {
+
+	ConnectionPool::SharedCache::SharedCache(const Options& options, const bool share_connections) : share(curl_share_init()) {
+		if (!share) {
+			throw std::runtime_error("curl_share_init failed");
+		}
+
+		curl_share_setopt(share, CURLSHOPT_LOCKFUNC, &ConnectionPool::lock_callback);
+		curl_share_setopt(share, CURLSHOPT_UNLOCKFUNC, &ConnectionPool::unlock_callback);
+		curl_share_setopt(share, CURLSHOPT_USERDATA, this);
+		if (share_connections) {
+			curl_share_setopt(share, CURLSHOPT_SHARE, CURL_LOCK_DATA_CONNECT);
+		}
+		if (options.share_dns) {
+			curl_share_setopt(share, CURLSHOPT_SHARE, CURL_LOCK_DATA_DNS);
+		}
+		if (options.share_tls_sessions) {
+			curl_share_setopt(share, CURLSHOPT_SHARE, CURL_LOCK_DATA_SSL_SESSION);
+		}
+	}
+
+	ConnectionPool::SharedCache::~SharedCache() {
+		curl_share_cleanup(share);
+	}
+
+	ConnectionPool::Lease::Lease(ConnectionPool& pool, CURL* easy, std::string_view origin, const PerformMode mode) :
+		pool_(&pool),
+		easy_(easy),
+		cache_(pool.attach(origin, mode))
+	{
+		const Options& options = pool.options();
+
+		if (cache_) {
+			curl_easy_setopt(easy_, CURLOPT_SHARE, cache_->share);
+		}
+		// applies only to blocking perform, event loop takes CURLMOPT_MAXCONNECTS of its multi handle
+		curl_easy_setopt(easy_, CURLOPT_MAXCONNECTS, options.max_idle_connections);
+		curl_easy_setopt(easy_, CURLOPT_MAXAGE_CONN, static_cast<long>(options.idle_timeout.count()));
+		if (options.max_connection_age) {
+			curl_easy_setopt(easy_, CURLOPT_MAXLIFETIME_CONN, static_cast<long>(options.max_connection_age->count()));
+		}
+
+		// called only if host isn't found in DNS cache
+		curl_easy_setopt(easy_, CURLOPT_RESOLVER_START_FUNCTION, &Lease::resolver_start_callback);
+		curl_easy_setopt(easy_, CURLOPT_RESOLVER_START_DATA, this);
+		// called when connection is ready, after TLS handshake
+		curl_easy_setopt(easy_, CURLOPT_PREREQFUNCTION, &Lease::prereq_callback);
+		curl_easy_setopt(easy_, CURLOPT_PREREQDATA, this);
+	}
+
+	ConnectionPool::Lease::~Lease() {
+		release(false);
+	}
+
+	void ConnectionPool::Lease::release(const bool record_statistics) noexcept {
+		if (!easy_) {
+			return;
+		}
+
+		if (record_statistics) {
+			long new_connections = 0;
+			curl_easy_getinfo(easy_, CURLINFO_NUM_CONNECTS, &new_connections);
+
+			if (new_connections == 0) {
+				pool_->connection_hits_.fetch_add(1, std::memory_order_relaxed);
+			}
+			else {
+				pool_->connection_misses_.fetch_add(1, std::memory_order_relaxed);
+				(resolver_started_ ? pool_->dns_misses_ : pool_->dns_hits_).fetch_add(1, std::memory_order_relaxed);
+
+				const char* scheme = nullptr;
+				curl_easy_getinfo(easy_, CURLINFO_SCHEME, &scheme);
+				if (scheme && is_tls_scheme(scheme) && tls_session_reused_) {
+					(*tls_session_reused_ ? pool_->tls_session_cache_hits_ : pool_->tls_session_cache_misses_).fetch_add(1, std::memory_order_relaxed);
+				}
+			}
+		}
+
+		curl_easy_setopt(easy_, CURLOPT_RESOLVER_START_FUNCTION, nullptr);
+		curl_easy_setopt(easy_, CURLOPT_RESOLVER_START_DATA, nullptr);
+		curl_easy_setopt(easy_, CURLOPT_PREREQFUNCTION, nullptr);
+		curl_easy_setopt(easy_, CURLOPT_PREREQDATA, nullptr);
+		curl_easy_setopt(easy_, CURLOPT_SHARE, nullptr);
+		easy_ = nullptr;
+		pool_->detach(cache_);
+	}
+
+	int ConnectionPool::Lease::resolver_start_callback(void*, void*, void* userdata) {
+		static_cast<Lease*>(userdata)->resolver_started_ = true;
+		return curl_continue_resolve;
+	}
+
+	int ConnectionPool::Lease::prereq_callback(void* userdata, char*, char*, int, int) {
+		Lease* lease = static_cast<Lease*>(userdata);
+		// TLS internals are available only while the transfer holds the connection
+		lease->tls_session_reused_ = is_tls_session_reused(lease->easy_);
+		return curl_prereq_ok;
+	}
+
+	ConnectionPool::ConnectionPool() : ConnectionPool(Options{}) {
+
+	}
+
+	ConnectionPool::ConnectionPool(const Options& options) : options_(options) {
+		if (options_.share_dns || options_.share_tls_sessions) {
+			session_cache_ = std::make_unique<SharedCache>(options_, false);
+		}
+	}
+
+	ConnectionPool::~ConnectionPool() = default;
+
+	const void* ConnectionPool::current_thread_owner() noexcept {
+		// address is unique among alive threads
+		thread_local const char owner = 0;
+		return &owner;
+	}
+
+	size_t ConnectionPool::origins_count() const {
+		std::lock_guard lock(mutex_);
+		return origins_.size();
+	}
+
+	const ConnectionPool::Options& ConnectionPool::options() const noexcept {
+		return options_;
+	}
+
+	ConnectionPool::Statistics ConnectionPool::statistics() const noexcept {
+		return Statistics{
+			.connection_hits = connection_hits_.load(std::memory_order_relaxed),
+			.connection_misses = connection_misses_.load(std::memory_order_relaxed),
+			.dns_hits = dns_hits_.load(std::memory_order_relaxed),
+			.dns_misses = dns_misses_.load(std::memory_order_relaxed),
+			.tls_session_cache_hits = tls_session_cache_hits_.load(std::memory_order_relaxed),
+			.tls_session_cache_misses = tls_session_cache_misses_.load(std::memory_order_relaxed)
+		};
+	}
+
+	size_t ConnectionPool::OriginKeyHash::operator()(const OriginKey& key) const noexcept {
+		return std::hash<std::string>{}(key.origin) ^ (std::hash<const void*>{}(key.owner) << 1);
+	}
+
+	ConnectionPool::SharedCache* ConnectionPool::attach(std::string_view origin, const PerformMode mode) {
+		if (mode == PerformMode::MultiHandle) {
+			return session_cache_.get();
+		}
+
+		std::lock_guard lock(mutex_);
+		evict_idle(std::chrono::steady_clock::now());
+
+		auto& cache = origins_[OriginKey{ .origin = std::string(origin), .owner = current_thread_owner() }];
+		if (!cache) {
+			cache = std::make_unique<SharedCache>(options_, true);
+		}
+		cache->leases++;
+		return cache.get();
+	}
+
+	void ConnectionPool::detach(SharedCache* cache) noexcept {
+		if (!cache || cache == session_cache_.get()) {
+			return;
+		}
+
+		std::lock_guard lock(mutex_);
+		cache->leases--;
+		cache->last_used = std::chrono::steady_clock::now();
+	}
+
+	void ConnectionPool::evict_idle(const std::chrono::steady_clock::time_point now) {
+		if (now < next_eviction_) {
+			return;
+		}
+		next_eviction_ = now + options_.idle_timeout;
+
+		// connections of such cache are expired anyway, and owner thread may be gone
+		std::erase_if(origins_, [&](const auto& item) {
+			const SharedCache& cache = *item.second;
+			return cache.leases == 0 && now - cache.last_used >= options_.idle_timeout;
+		});
+	}
+
+	void ConnectionPool::lock_callback(CURL*, curl_lock_data data, curl_lock_access, void* userptr) {
+		static_cast<SharedCache*>(userptr)->mutexes[data].lock();
+	}
+
+	void ConnectionPool::unlock_callback(CURL*, curl_lock_data data, void* userptr) {
+		static_cast<SharedCache*>(userptr)->mutexes[data].unlock();
+	}
+}
@@ -0,0 +1,27 @@
+#include <asyncnet/Exceptions.hpp>
+
+namespace asyncnet {
+	const char* error_string(const TimeoutKind kind) noexcept {
+		switch (kind) {
+		case TimeoutKind::Connect:
+			return "Connect timeout was reached";
+		case TimeoutKind::FirstByte:
+			return "First byte timeout was reached";
+		case TimeoutKind::Idle:
+			return "Idle timeout was reached";
+		default:
+			return curl_easy_strerror(TimeoutErrorCode);
+		}
+	}
+
+	TimeoutError::TimeoutError(const TimeoutKind kind) :
+		NetworkRuntimeError(error_string(kind), TimeoutErrorCode),
+		kind_(kind)
+	{
+
+	}
+
+	TimeoutKind TimeoutError::kind() const noexcept {
+		return kind_;
+	}
+}
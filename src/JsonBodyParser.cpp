@@ -0,0 +1,46 @@
+#include <asyncnet/detail/JsonBodyParser.hpp>
+
+namespace asyncnet::detail {
+
+	JsonBodyParser::JsonBodyParser(boost::json::storage_ptr storage) : storage_(std::move(storage)) {
+		parser_.reset(storage_);
+	}
+
+	size_t JsonBodyParser::write(const char* data, const size_t size) {
+		if (error_) {
+			return size;
+		}
+
+		is_empty_ = is_empty_ && size == 0;
+		parser_.write(data, size, error_);
+		return size;
+	}
+
+	bool JsonBodyParser::failed() const noexcept {
+		return static_cast<bool>(error_);
+	}
+
+	boost::json::value JsonBodyParser::finish() {
+		boost::system::error_code error;
+		boost::json::value value = finish(error);
+		if (error) {
+			throw boost::system::system_error(error);
+		}
+		return value;
+	}
+
+	boost::json::value JsonBodyParser::finish(boost::system::error_code& error) {
+		if (!error_ && is_empty_) {
+			return boost::json::value(storage_);
+		}
+
+		if (!error_) {
+			parser_.finish(error_);
+		}
+		if (error_) {
+			error = error_;
+			return boost::json::value(storage_);
+		}
+		return parser_.release();
+	}
+}
@@ -0,0 +1,18 @@
+#include <asyncnet/JsonBodySource.hpp>
+
+namespace asyncnet {
+
+	coro::task<std::optional<std::string>> JsonBodySource::operator()() {
+		if (!state_) {
+			state_ = std::make_shared<State>();
+			reset_(state_->serializer, state_->document);
+		}
+		if (state_->serializer.done()) {
+			co_return std::nullopt;
+		}
+
+		std::string chunk(chunk_size_, '\0');
+		chunk.resize(state_->serializer.read(chunk.data(), chunk.size()).size());
+		co_return chunk;
+	}
+}
@@ -0,0 +1,428 @@
+#include <asyncnet/JsonFieldExtractor.hpp>
+
+#include <charconv>
+#include <stdexcept>
+#include <utility>
+
+#pragma warning(push, 0)
+#include <boost/json/basic_parser_impl.hpp>
+#pragma warning(pop)
+
+namespace {
+	struct PointerToken {
+		std::string key;
+		/// Set if the token can be an array index
+		std::optional<size_t> index;
+	};
+
+	struct FieldPointer {
+		std::string text;
+		std::vector<PointerToken> tokens;
+		/// Pointer, which is a prefix of this one, so the value is taken from its value
+		std::optional<size_t> parent;
+		/// Count of leading tokens matched by current path
+		size_t matched = 0;
+	};
+
+	std::vector<PointerToken> split_pointer(const std::string_view pointer) {
+		if (!pointer.empty() && pointer.front() != '/') {
+			throw std::invalid_argument("JSON Pointer must start with '/'");
+		}
+
+		std::vector<PointerToken> tokens;
+		size_t begin = 1;
+		while (begin <= pointer.size() && !pointer.empty()) {
+			const size_t end = std::min(pointer.find('/', begin), pointer.size());
+			PointerToken token;
+			for (size_t i = begin; i < end; i++) {
+				if (pointer[i] != '~') {
+					token.key += pointer[i];
+				}
+				else if (i + 1 < end && (pointer[i + 1] == '0' || pointer[i + 1] == '1')) {
+					token.key += pointer[++i] == '0' ? '~' : '/';
+				}
+				else {
+					throw std::invalid_argument("JSON Pointer has invalid escape");
+				}
+			}
+
+			size_t index = 0;
+			const char* key_end = token.key.data() + token.key.size();
+			const bool is_canonical = token.key == "0" || (!token.key.empty() && token.key.front() != '0');
+			if (is_canonical && std::from_chars(token.key.data(), key_end, index).ptr == key_end) {
+				token.index = index;
+			}
+
+			tokens.push_back(std::move(token));
+			begin = end + 1;
+		}
+		return tokens;
+	}
+
+	bool is_prefix(const std::vector<PointerToken>& prefix, const std::vector<PointerToken>& tokens) {
+		if (prefix.size() > tokens.size()) {
+			return false;
+		}
+		for (size_t i = 0; i < prefix.size(); i++) {
+			if (prefix[i].key != tokens[i].key) {
+				return false;
+			}
+		}
+		return true;
+	}
+
+	/**
+	 * SAX handler, which tracks path of the current value and builds only values at the pointers
+	 */
+	class FieldHandler {
+	public:
+		static constexpr size_t max_object_size = boost::json::object::max_size();
+		static constexpr size_t max_array_size = boost::json::array::max_size();
+		static constexpr size_t max_key_size = boost::json::string::max_size();
+		static constexpr size_t max_string_size = boost::json::string::max_size();
+
+		FieldHandler(const std::vector<std::string>& pointers, boost::json::storage_ptr storage) :
+			storage_(std::move(storage)),
+			values_(pointers.size())
+		{
+			pointers_.reserve(pointers.size());
+			for (const std::string& pointer : pointers) {
+				pointers_.push_back({ .text = pointer, .tokens = split_pointer(pointer) });
+			}
+
+			// nested pointer is resolved from value of the shortest enclosing one
+			for (size_t i = 0; i < pointers_.size(); i++) {
+				for (size_t j = 0; j < pointers_.size(); j++) {
+					const bool is_shorter = pointers_[j].tokens.size() < pointers_[i].tokens.size() || (pointers_[j].tokens.size() == pointers_[i].tokens.size() && j < i);
+					const bool is_better = !pointers_[i].parent || pointers_[j].tokens.size() < pointers_[*pointers_[i].parent].tokens.size();
+					if (i != j && is_shorter && is_better && is_prefix(pointers_[j].tokens, pointers_[i].tokens)) {
+						pointers_[i].parent = j;
+					}
+				}
+				if (!pointers_[i].parent) {
+					pending_count_++;
+				}
+			}
+		}
+
+		bool on_document_begin(boost::system::error_code&) {
+			return true;
+		}
+
+		bool on_document_end(boost::system::error_code&) {
+			return true;
+		}
+
+		bool on_array_begin(boost::system::error_code&) {
+			begin_container(true);
+			return true;
+		}
+
+		bool on_array_end(const size_t count, boost::system::error_code& error) {
+			if (capture_depth_ != 0) {
+				stack_.push_array(count);
+			}
+			return end_container(error);
+		}
+
+		bool on_object_begin(boost::system::error_code&) {
+			begin_container(false);
+			return true;
+		}
+
+		bool on_object_end(const size_t count, boost::system::error_code& error) {
+			if (capture_depth_ != 0) {
+				stack_.push_object(count);
+			}
+			return end_container(error);
+		}
+
+		bool on_string_part(const boost::json::string_view part, size_t, boost::system::error_code&) {
+			if (!in_value_) {
+				begin_value();
+			}
+			if (capture_index_) {
+				stack_.push_chars(part);
+			}
+			return true;
+		}
+
+		bool on_string(const boost::json::string_view part, size_t, boost::system::error_code& error) {
+			if (!in_value_) {
+				begin_value();
+			}
+			if (capture_index_) {
+				stack_.push_string(part);
+			}
+			return end_scalar(error);
+		}
+
+		bool on_key_part(const boost::json::string_view part, size_t, boost::system::error_code&) {
+			if (capture_index_) {
+				stack_.push_chars(part);
+			}
+			else {
+				frames_[depth_ - 1].key.append(part.data(), part.size());
+			}
+			return true;
+		}
+
+		bool on_key(const boost::json::string_view part, size_t, boost::system::error_code&) {
+			if (capture_index_) {
+				stack_.push_key(part);
+				return true;
+			}
+
+			std::string& key = frames_[depth_ - 1].key;
+			key.append(part.data(), part.size());
+			enter_element(depth_ - 1, [&key](const PointerToken& token) {
+				return token.key == key;
+			});
+			// buffer keeps capacity for the next key
+			key.clear();
+			return true;
+		}
+
+		bool on_number_part(boost::json::string_view, boost::system::error_code&) {
+			if (!in_value_) {
+				begin_value();
+			}
+			return true;
+		}
+
+		bool on_int64(const int64_t value, boost::json::string_view, boost::system::error_code& error) {
+			if (!in_value_) {
+				begin_value();
+			}
+			if (capture_index_) {
+				stack_.push_int64(value);
+			}
+			return end_scalar(error);
+		}
+
+		bool on_uint64(const uint64_t value, boost::json::string_view, boost::system::error_code& error) {
+			if (!in_value_) {
+				begin_value();
+			}
+			if (capture_index_) {
+				stack_.push_uint64(value);
+			}
+			return end_scalar(error);
+		}
+
+		bool on_double(const double value, boost::json::string_view, boost::system::error_code& error) {
+			if (!in_value_) {
+				begin_value();
+			}
+			if (capture_index_) {
+				stack_.push_double(value);
+			}
+			return end_scalar(error);
+		}
+
+		bool on_bool(const bool value, boost::system::error_code& error) {
+			begin_value();
+			if (capture_index_) {
+				stack_.push_bool(value);
+			}
+			return end_scalar(error);
+		}
+
+		bool on_null(boost::system::error_code& error) {
+			begin_value();
+			if (capture_index_) {
+				stack_.push_null();
+			}
+			return end_scalar(error);
+		}
+
+		bool on_comment_part(boost::json::string_view, boost::system::error_code&) {
+			return true;
+		}
+
+		bool on_comment(boost::json::string_view, boost::system::error_code&) {
+			return true;
+		}
+
+		bool done() const noexcept {
+			return pending_count_ == 0;
+		}
+
+		std::vector<std::optional<boost::json::value>> release() {
+			for (size_t i = 0; i < pointers_.size(); i++) {
+				const FieldPointer& pointer = pointers_[i];
+				if (!pointer.parent || !values_[*pointer.parent]) {
+					continue;
+				}
+
+				boost::system::error_code error;
+				const std::string_view rest = std::string_view(pointer.text).substr(pointers_[*pointer.parent].text.size());
+				if (const boost::json::value* value = values_[*pointer.parent]->find_pointer(rest, error)) {
+					values_[i].emplace(*value, storage_);
+				}
+			}
+			return std::move(values_);
+		}
+
+	private:
+		struct Frame {
+			bool is_array = false;
+			size_t index = 0;
+			/// Buffer of the current key, which keeps capacity between objects
+			std::string key;
+		};
+
+		template<typename Match>
+		void enter_element(const size_t depth, const Match& match) {
+			for (FieldPointer& pointer : pointers_) {
+				if (pointer.matched >= depth && !pointer.parent) {
+					pointer.matched = depth + (depth < pointer.tokens.size() && match(pointer.tokens[depth]) ? 1 : 0);
+				}
+			}
+		}
+
+		void begin_value() {
+			in_value_ = true;
+			if (capture_index_) {
+				return;
+			}
+
+			if (depth_ != 0 && frames_[depth_ - 1].is_array) {
+				const size_t index = frames_[depth_ - 1].index++;
+				enter_element(depth_ - 1, [index](const PointerToken& token) {
+					return token.index == index;
+				});
+			}
+
+			for (size_t i = 0; i < pointers_.size(); i++) {
+				const FieldPointer& pointer = pointers_[i];
+				if (!pointer.parent && !values_[i] && pointer.tokens.size() == depth_ && pointer.matched == depth_) {
+					capture_index_ = i;
+					stack_.reset(storage_);
+					return;
+				}
+			}
+		}
+
+		void begin_container(const bool is_array) {
+			begin_value();
+			in_value_ = false;
+			if (capture_index_) {
+				capture_depth_++;
+			}
+
+			if (frames_.size() == depth_) {
+				frames_.emplace_back();
+			}
+			Frame& frame = frames_[depth_++];
+			frame.is_array = is_array;
+			frame.index = 0;
+			frame.key.clear();
+		}
+
+		bool end_container(boost::system::error_code& error) {
+			depth_--;
+			if (capture_index_) {
+				capture_depth_--;
+			}
+			return end_scalar(error);
+		}
+
+		bool end_scalar(boost::system::error_code& error) {
+			in_value_ = false;
+			if (!capture_index_ || capture_depth_ != 0) {
+				return true;
+			}
+
+			values_[*capture_index_] = stack_.release();
+			capture_index_.reset();
+			pending_count_--;
+			if (pending_count_ != 0) {
+				return true;
+			}
+
+			// every value is found, so the rest of text is skipped
+			error = boost::system::errc::make_error_code(boost::system::errc::operation_canceled);
+			return false;
+		}
+
+		boost::json::storage_ptr storage_;
+		std::vector<FieldPointer> pointers_;
+		std::vector<std::optional<boost::json::value>> values_;
+		size_t pending_count_ = 0;
+		std::vector<Frame> frames_;
+		size_t depth_ = 0;
+		bool in_value_ = false;
+		/// Pointer, which value is being built
+		std::optional<size_t> capture_index_;
+		/// Depth of containers inside the built value
+		size_t capture_depth_ = 0;
+		boost::json::value_stack stack_;
+	};
+}
+
+namespace asyncnet {
+
+	class JsonFieldExtractor::Parser {
+	public:
+		Parser(const std::vector<std::string>& pointers, boost::json::storage_ptr storage) :
+			parser_(boost::json::parse_options{}, pointers, std::move(storage))
+		{
+
+		}
+
+		void write(const std::string_view chunk, const bool more) {
+			if (parser_.handler().done()) {
+				return;
+			}
+
+			boost::system::error_code error;
+			parser_.write_some(more, chunk.data(), chunk.size(), error);
+			if (error && !parser_.handler().done()) {
+				throw boost::system::system_error(error);
+			}
+		}
+
+		bool done() const noexcept {
+			return parser_.handler().done();
+		}
+
+		std::vector<std::optional<boost::json::value>> release() {
+			return parser_.handler().release();
+		}
+
+	private:
+		boost::json::basic_parser<FieldHandler> parser_;
+	};
+
+	JsonFieldExtractor::JsonFieldExtractor(const std::vector<std::string>& pointers, boost::json::storage_ptr storage) :
+		parser_(std::make_unique<Parser>(pointers, std::move(storage)))
+	{
+
+	}
+
+	JsonFieldExtractor::JsonFieldExtractor(JsonFieldExtractor&& other) noexcept = default;
+
+	JsonFieldExtractor& JsonFieldExtractor::operator=(JsonFieldExtractor&& other) noexcept = default;
+
+	JsonFieldExtractor::~JsonFieldExtractor() = default;
+
+	void JsonFieldExtractor::write(const std::string_view chunk) {
+		parser_->write(chunk, true);
+	}
+
+	bool JsonFieldExtractor::done() const noexcept {
+		return parser_->done();
+	}
+
+	std::vector<std::optional<boost::json::value>> JsonFieldExtractor::finish() {
+		parser_->write({}, false);
+		return parser_->release();
+	}
+
+	std::vector<std::optional<boost::json::value>> extract_json_fields(std::string_view from, const std::vector<std::string>& pointers, boost::json::storage_ptr storage) {
+		JsonFieldExtractor extractor(pointers, std::move(storage));
+		extractor.write(from);
+		return extractor.finish();
+	}
+}
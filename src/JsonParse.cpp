@@ -0,0 +1,321 @@
+#include <asyncnet/detail/JsonParse.hpp>
+
+#pragma warning(push, 0)
+#include <boost/json/basic_parser_impl.hpp>
+#pragma warning(pop)
+
+namespace {
+	using asyncnet::detail::JsonIntoOps;
+
+	/**
+	 * SAX handler, which fills value by @ref JsonIntoOps of its type and skips values of unknown keys without building them
+	 */
+	class IntoHandler {
+	public:
+		static constexpr size_t max_object_size = boost::json::object::max_size();
+		static constexpr size_t max_array_size = boost::json::array::max_size();
+		static constexpr size_t max_key_size = boost::json::string::max_size();
+		static constexpr size_t max_string_size = boost::json::string::max_size();
+
+		IntoHandler(void* target, const JsonIntoOps* ops) : next_{ .target = target, .ops = ops } {
+
+		}
+
+		bool on_document_begin(boost::system::error_code&) {
+			return true;
+		}
+
+		bool on_document_end(boost::system::error_code&) {
+			return true;
+		}
+
+		bool on_array_begin(boost::system::error_code& error) {
+			if (skip_depth_ != 0) {
+				skip_depth_++;
+				return true;
+			}
+
+			const Value value = begin_value(false);
+			if (!value.target) {
+				skip_depth_ = 1;
+				return true;
+			}
+			if (!value.ops->on_array_begin) {
+				return fail(value, error);
+			}
+
+			value.ops->on_array_begin(value.target);
+			push_frame(value, true);
+			return true;
+		}
+
+		bool on_array_end(size_t, boost::system::error_code&) {
+			if (skip_depth_ != 0) {
+				skip_depth_--;
+				return true;
+			}
+
+			depth_--;
+			return true;
+		}
+
+		bool on_object_begin(boost::system::error_code& error) {
+			if (skip_depth_ != 0) {
+				skip_depth_++;
+				return true;
+			}
+
+			const Value value = begin_value(false);
+			if (!value.target) {
+				skip_depth_ = 1;
+				return true;
+			}
+			if (!value.ops->on_object_begin) {
+				return fail(value, error);
+			}
+
+			Frame& frame = push_frame(value, false);
+			value.ops->on_object_begin(value.target, frame.filled);
+			return true;
+		}
+
+		bool on_object_end(size_t, boost::system::error_code& error) {
+			if (skip_depth_ != 0) {
+				skip_depth_--;
+				return true;
+			}
+
+			const Frame& frame = frames_[--depth_];
+			if (!frame.value.ops->on_object_end(frame.filled)) {
+				error = boost::json::error::size_mismatch;
+				return false;
+			}
+			return true;
+		}
+
+		bool on_key_part(const boost::json::string_view part, size_t, boost::system::error_code&) {
+			if (skip_depth_ == 0) {
+				frames_[depth_ - 1].key.append(part.data(), part.size());
+			}
+			return true;
+		}
+
+		bool on_key(const boost::json::string_view part, size_t, boost::system::error_code&) {
+			if (skip_depth_ != 0) {
+				return true;
+			}
+
+			Frame& frame = frames_[depth_ - 1];
+			std::string_view key(part.data(), part.size());
+			if (!frame.key.empty()) {
+				frame.key.append(part.data(), part.size());
+				key = frame.key;
+			}
+
+			// value of unknown key gets nullptr target, so it's skipped
+			const JsonIntoOps* ops = nullptr;
+			void* member = frame.value.ops->find_member(frame.value.target, key, frame.filled, &ops);
+			next_ = { .target = member, .ops = ops };
+
+			// buffer keeps capacity for the next key
+			frame.key.clear();
+			return true;
+		}
+
+		bool on_string_part(const boost::json::string_view part, size_t, boost::system::error_code&) {
+			if (skip_depth_ != 0) {
+				return true;
+			}
+
+			if (!in_string_) {
+				string_value_ = begin_value(false);
+				in_string_ = true;
+			}
+			if (string_value_.target) {
+				string_.append(part.data(), part.size());
+			}
+			return true;
+		}
+
+		bool on_string(const boost::json::string_view part, size_t, boost::system::error_code& error) {
+			if (skip_depth_ != 0) {
+				return true;
+			}
+
+			const Value value = in_string_ ? string_value_ : begin_value(false);
+			in_string_ = false;
+			if (!value.target) {
+				string_.clear();
+				return true;
+			}
+			if (!value.ops->on_string) {
+				return fail(value, error);
+			}
+
+			if (string_.empty()) {
+				value.ops->on_string(value.target, std::string_view(part.data(), part.size()));
+			}
+			else {
+				string_.append(part.data(), part.size());
+				value.ops->on_string(value.target, string_);
+				string_.clear();
+			}
+			return true;
+		}
+
+		bool on_number_part(boost::json::string_view, boost::system::error_code&) {
+			return true;
+		}
+
+		bool on_int64(const int64_t number, boost::json::string_view, boost::system::error_code& error) {
+			return on_number(number, &JsonIntoOps::on_int64, error);
+		}
+
+		bool on_uint64(const uint64_t number, boost::json::string_view, boost::system::error_code& error) {
+			return on_number(number, &JsonIntoOps::on_uint64, error);
+		}
+
+		bool on_double(const double number, boost::json::string_view, boost::system::error_code& error) {
+			return on_number(number, &JsonIntoOps::on_double, error);
+		}
+
+		bool on_bool(const bool flag, boost::system::error_code& error) {
+			if (skip_depth_ != 0) {
+				return true;
+			}
+
+			const Value value = begin_value(false);
+			if (!value.target) {
+				return true;
+			}
+			if (!value.ops->on_bool) {
+				return fail(value, error);
+			}
+
+			value.ops->on_bool(value.target, flag);
+			return true;
+		}
+
+		bool on_null(boost::system::error_code& error) {
+			if (skip_depth_ != 0) {
+				return true;
+			}
+
+			const Value value = begin_value(true);
+			if (!value.target) {
+				return true;
+			}
+			if (!value.ops->on_null) {
+				return fail(value, error);
+			}
+
+			value.ops->on_null(value.target);
+			return true;
+		}
+
+		bool on_comment_part(boost::json::string_view, boost::system::error_code&) {
+			return true;
+		}
+
+		bool on_comment(boost::json::string_view, boost::system::error_code&) {
+			return true;
+		}
+
+	private:
+		struct Value {
+			/// Value to fill or nullptr if the value is skipped
+			void* target = nullptr;
+			const JsonIntoOps* ops = nullptr;
+		};
+
+		struct Frame {
+			Value value;
+			bool is_array = false;
+			/// Buffer of the current key, which keeps capacity between objects
+			std::string key;
+			/// Found members of struct
+			std::vector<bool> filled;
+		};
+
+		template<typename Number>
+		bool on_number(const Number number, bool (*JsonIntoOps::* assign)(void*, const Number), boost::system::error_code& error) {
+			if (skip_depth_ != 0) {
+				return true;
+			}
+
+			const Value value = begin_value(false);
+			if (!value.target) {
+				return true;
+			}
+			if (!(value.ops->*assign)) {
+				return fail(value, error);
+			}
+
+			if (!(value.ops->*assign)(value.target, number)) {
+				error = boost::json::error::not_exact;
+				return false;
+			}
+			return true;
+		}
+
+		/**
+		 * @param is_null Set to true if the value is null, so optional isn't constructed
+		 * @return Returns array element or value of the last key to fill
+		 */
+		Value begin_value(const bool is_null) {
+			Value value = next_;
+			if (depth_ != 0 && frames_[depth_ - 1].is_array) {
+				const Value& array = frames_[depth_ - 1].value;
+				value.target = array.ops->next_element(array.target, &value.ops);
+			}
+
+			while (value.target && value.ops->emplace && !is_null) {
+				value.target = value.ops->emplace(value.target, &value.ops);
+			}
+			return value;
+		}
+
+		Frame& push_frame(const Value& value, const bool is_array) {
+			if (frames_.size() == depth_) {
+				frames_.emplace_back();
+			}
+
+			Frame& frame = frames_[depth_++];
+			frame.value = value;
+			frame.is_array = is_array;
+			frame.key.clear();
+			return frame;
+		}
+
+		static bool fail(const Value& value, boost::system::error_code& error) {
+			error = value.ops->mismatch;
+			return false;
+		}
+
+		/// Value of the document or of the last key
+		Value next_;
+		std::vector<Frame> frames_;
+		size_t depth_ = 0;
+		/// Depth of containers inside the skipped value
+		size_t skip_depth_ = 0;
+		bool in_string_ = false;
+		/// Value of the string, which is received by parts
+		Value string_value_;
+		std::string string_;
+	};
+}
+
+namespace asyncnet::detail {
+	void parse_json_into(std::string_view from, void* target, const JsonIntoOps& ops) {
+		boost::json::basic_parser<IntoHandler> parser(boost::json::parse_options{}, target, &ops);
+
+		boost::system::error_code error;
+		const size_t size = parser.write_some(false, from.data(), from.size(), error);
+		if (!error && size != from.size()) {
+			error = boost::json::error::extra_data;
+		}
+		if (error) {
+			throw boost::system::system_error(error);
+		}
+	}
+}
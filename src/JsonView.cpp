@@ -0,0 +1,71 @@
+#if ASYNCNET_USE_SIMDJSON
+#include <asyncnet/JsonView.hpp>
+
+namespace {
+	static_assert(SIMDJSON_PADDING <= asyncnet::ResponseBody::tail_padding, "response body padding is less than simdjson needs");
+
+	template<typename Json>
+	boost::json::value to_boost_value(Json& json, const boost::json::storage_ptr& storage) {
+		switch (simdjson::ondemand::json_type(json.type())) {
+		case simdjson::ondemand::json_type::array: {
+			boost::json::array array(storage);
+			for (simdjson::ondemand::value element : json.get_array()) {
+				array.push_back(to_boost_value(element, storage));
+			}
+			return array;
+		}
+		case simdjson::ondemand::json_type::object: {
+			boost::json::object object(storage);
+			for (simdjson::ondemand::field field : json.get_object()) {
+				// key must be read before the value
+				const std::string_view key = field.unescaped_key();
+				simdjson::ondemand::value value = field.value();
+				object.insert_or_assign(key, to_boost_value(value, storage));
+			}
+			return object;
+		}
+		case simdjson::ondemand::json_type::number:
+			switch (simdjson::ondemand::number_type(json.get_number_type())) {
+			case simdjson::ondemand::number_type::signed_integer:
+				return boost::json::value(int64_t(json.get_int64()), storage);
+			case simdjson::ondemand::number_type::unsigned_integer:
+				return boost::json::value(uint64_t(json.get_uint64()), storage);
+			default:
+				return boost::json::value(double(json.get_double()), storage);
+			}
+		case simdjson::ondemand::json_type::string:
+			return boost::json::string(std::string_view(json.get_string()), storage);
+		case simdjson::ondemand::json_type::boolean:
+			return boost::json::value(bool(json.get_bool()), storage);
+		default:
+			return boost::json::value(storage);
+		}
+	}
+}
+
+namespace asyncnet {
+
+	JsonView::JsonView(const Response& response) : parser_(std::make_unique<simdjson::ondemand::parser>()) {
+		const std::string_view body = response.get_body().padded_view();
+		document_ = parser_->iterate(simdjson::padded_string_view(body.data(), body.size(), body.size() + ResponseBody::tail_padding));
+	}
+
+	JsonView::JsonView(const std::string_view json) :
+		text_(json),
+		parser_(std::make_unique<simdjson::ondemand::parser>())
+	{
+		document_ = parser_->iterate(text_);
+	}
+
+	simdjson::ondemand::document& JsonView::document() noexcept {
+		return document_;
+	}
+
+	boost::json::value JsonView::to_value(boost::json::storage_ptr storage) {
+		document_.rewind();
+		boost::json::value value = to_boost_value(document_, storage);
+		document_.rewind();
+		return value;
+	}
+}
+#endif
@@ -0,0 +1,739 @@
+#include <asyncnet/detail/MultiEngine.hpp>
+#include <asyncnet/Exceptions.hpp>
+
+#include <algorithm>
+#include <array>
+#include <limits>
+#include <stdexcept>
+#include <system_error>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#if defined(__linux__)
+# include <pthread.h>
+# include <sched.h>
+# include <sys/epoll.h>
+# include <sys/eventfd.h>
+# include <unistd.h>
+#endif
+
+namespace {
+	/**
+	 * @return Returns CPUs, which the process may run on
+	 */
+	std::vector<unsigned> allowed_cpus() {
+		std::vector<unsigned> cpus;
+#if defined(__linux__)
+		cpu_set_t cpu_set;
+		CPU_ZERO(&cpu_set);
+		if (sched_getaffinity(0, sizeof(cpu_set), &cpu_set) == 0) {
+			for (unsigned cpu = 0; cpu < CPU_SETSIZE; cpu++) {
+				if (CPU_ISSET(cpu, &cpu_set)) {
+					cpus.push_back(cpu);
+				}
+			}
+		}
+#endif
+		if (cpus.empty()) {
+			for (unsigned cpu = 0; cpu < std::max(std::thread::hardware_concurrency(), 1u); cpu++) {
+				cpus.push_back(cpu);
+			}
+		}
+		return cpus;
+	}
+}
+
+namespace asyncnet::detail {
+
+	MultiEngine::MultiEngine(const std::optional<unsigned>& cpu) : multi_(curl_multi_init()) {
+		initialize();
+
+		thread_ = std::thread([this] {
+			run();
+		});
+
+#if defined(__linux__)
+		if (cpu) {
+			cpu_set_t cpu_set;
+			CPU_ZERO(&cpu_set);
+			CPU_SET(*cpu, &cpu_set);
+			// pinning is an optimization, so the loop works on any core if it fails
+			pthread_setaffinity_np(thread_.native_handle(), sizeof(cpu_set), &cpu_set);
+		}
+#endif
+	}
+
+#if defined(__linux__)
+	MultiEngine::MultiEngine(std::shared_ptr<coro::io_scheduler> scheduler) :
+		multi_(curl_multi_init()),
+		scheduler_(std::move(scheduler))
+	{
+		initialize();
+	}
+
+	std::shared_ptr<MultiEngine> MultiEngine::make_shared(std::shared_ptr<coro::io_scheduler> scheduler) {
+		// constructor is private, so std::make_shared can't be used
+		std::shared_ptr<MultiEngine> engine(new MultiEngine(std::move(scheduler)));
+		if (!engine->scheduler_->spawn(drive(engine))) {
+			throw std::runtime_error("failed to spawn event loop on shut down scheduler");
+		}
+		return engine;
+	}
+#endif
+
+	void MultiEngine::initialize() {
+		if (!multi_) {
+			throw std::runtime_error("curl_multi_init failed");
+		}
+
+		// HTTP/2 requests to the same origin share one connection
+		curl_multi_setopt(multi_, CURLMOPT_PIPELINING, CURLPIPE_MULTIPLEX);
+
+#if defined(__linux__)
+		epoll_fd_ = epoll_create1(EPOLL_CLOEXEC);
+		wake_fd_ = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+		if (epoll_fd_ < 0 || wake_fd_ < 0) {
+			const int error = errno;
+			if (epoll_fd_ >= 0) {
+				close(epoll_fd_);
+			}
+			if (wake_fd_ >= 0) {
+				close(wake_fd_);
+			}
+			curl_multi_cleanup(multi_);
+			throw std::system_error(error, std::system_category(), "failed to create event loop descriptors");
+		}
+
+		epoll_event wake_event{};
+		wake_event.events = EPOLLIN;
+		wake_event.data.fd = wake_fd_;
+		epoll_ctl(epoll_fd_, EPOLL_CTL_ADD, wake_fd_, &wake_event);
+
+		curl_multi_setopt(multi_, CURLMOPT_SOCKETFUNCTION, &MultiEngine::socket_callback);
+		curl_multi_setopt(multi_, CURLMOPT_SOCKETDATA, this);
+		curl_multi_setopt(multi_, CURLMOPT_TIMERFUNCTION, &MultiEngine::timer_callback);
+		curl_multi_setopt(multi_, CURLMOPT_TIMERDATA, this);
+#endif
+	}
+
+	MultiEngine::~MultiEngine() {
+		stop();
+
+		// loop running on scheduler owns the engine, so it's already finished
+		if (thread_.joinable()) {
+			thread_.join();
+		}
+
+		curl_multi_cleanup(multi_);
+#if defined(__linux__)
+		close(wake_fd_);
+		close(epoll_fd_);
+#endif
+	}
+
+	CompletionQueue::WaitAwaitable::WaitAwaitable(CompletionQueue& queue) noexcept : queue_(queue) {
+
+	}
+
+	bool CompletionQueue::WaitAwaitable::await_ready() const {
+		std::lock_guard lock(queue_.mutex_);
+		return !queue_.done_.empty();
+	}
+
+	bool CompletionQueue::WaitAwaitable::await_suspend(std::coroutine_handle<> coroutine) {
+		std::lock_guard lock(queue_.mutex_);
+		if (!queue_.done_.empty()) {
+			return false;
+		}
+		queue_.waiter_ = coroutine;
+		return true;
+	}
+
+	std::vector<size_t> CompletionQueue::WaitAwaitable::await_resume() {
+		std::lock_guard lock(queue_.mutex_);
+		return std::exchange(queue_.done_, {});
+	}
+
+	CompletionQueue::CompletionQueue(const size_t expected) : expected_(expected) {
+
+	}
+
+	void CompletionQueue::push(const size_t index) {
+		std::shared_ptr<void> owner;
+		{
+			std::lock_guard lock(mutex_);
+			done_.push_back(index);
+			pushed_++;
+			if (pushed_ == expected_) {
+				owner = std::move(owner_);
+			}
+		}
+		// abandoned batch is destroyed here, when its last transfer is done
+	}
+
+	void CompletionQueue::flush() {
+		std::coroutine_handle<> waiter;
+		{
+			std::lock_guard lock(mutex_);
+			if (done_.empty()) {
+				return;
+			}
+			waiter = std::exchange(waiter_, nullptr);
+		}
+
+		if (waiter) {
+			waiter.resume();
+		}
+	}
+
+	CompletionQueue::WaitAwaitable CompletionQueue::wait() noexcept {
+		return WaitAwaitable(*this);
+	}
+
+	void CompletionQueue::keep_alive(std::shared_ptr<void> owner) {
+		std::lock_guard lock(mutex_);
+		if (pushed_ != expected_) {
+			owner_ = std::move(owner);
+		}
+	}
+
+	size_t CompletionQueue::expected() const noexcept {
+		return expected_;
+	}
+
+	MultiEngine::PerformAwaitable::PerformAwaitable(MultiEngine& engine, CURL* easy, std::stop_token stop_token, const TransferTimeouts& timeouts) noexcept :
+		engine_(engine),
+		transfer_{ .easy = easy, .timeouts = timeouts },
+		stop_token_(std::move(stop_token))
+	{
+
+	}
+
+	bool MultiEngine::PerformAwaitable::await_ready() const noexcept {
+		return false;
+	}
+
+	bool MultiEngine::PerformAwaitable::await_suspend(std::coroutine_handle<> coroutine) {
+		transfer_.continuation = coroutine;
+
+		// registered before submitting, so the stop can't be missed. If stop is already requested, transfer won't be submitted
+		stop_callback_.emplace(stop_token_, Canceller{ &engine_, &transfer_ });
+		if (!engine_.submit(&transfer_)) {
+			transfer_.result.code = CURLE_ABORTED_BY_CALLBACK;
+			return false;
+		}
+
+		// the transfer may be already done on the loop thread, don't touch members here
+		return true;
+	}
+
+	TransferResult MultiEngine::PerformAwaitable::await_resume() const noexcept {
+		return transfer_.result;
+	}
+
+	void MultiEngine::PerformAwaitable::Canceller::operator()() const noexcept {
+		engine->cancel(transfer);
+	}
+
+	MultiEngine::PerformAwaitable MultiEngine::perform(CURL* easy, std::stop_token stop_token, const TransferTimeouts& timeouts) noexcept {
+		return PerformAwaitable(*this, easy, std::move(stop_token), timeouts);
+	}
+
+	bool MultiEngine::submit(Transfer* transfer) {
+		{
+			std::lock_guard lock(submit_mutex_);
+			if (transfer->cancelled) {
+				return false;
+			}
+
+			transfer->id = next_id_++;
+			transfer->submitted = true;
+			submitted_.push_back(transfer);
+			active_count_.fetch_add(1, std::memory_order_relaxed);
+		}
+		wake();
+		return true;
+	}
+
+	void MultiEngine::submit(std::span<Transfer* const> transfers) {
+		if (transfers.empty()) {
+			return;
+		}
+
+		{
+			std::lock_guard lock(submit_mutex_);
+			for (Transfer* transfer : transfers) {
+				transfer->id = next_id_++;
+				transfer->submitted = true;
+				submitted_.push_back(transfer);
+			}
+			active_count_.fetch_add(transfers.size(), std::memory_order_relaxed);
+		}
+		wake();
+	}
+
+	void MultiEngine::cancel(Transfer* transfer) {
+		{
+			std::lock_guard lock(submit_mutex_);
+			transfer->cancelled = true;
+			if (!transfer->submitted) {
+				return;
+			}
+
+			// transfer may be done before the loop handles it, so it's looked up by id
+			cancelled_.push_back(transfer->id);
+		}
+		wake();
+	}
+
+	void MultiEngine::unpause(const uint64_t id) {
+		{
+			std::lock_guard lock(submit_mutex_);
+			unpaused_.push_back(id);
+		}
+		wake();
+	}
+
+	void MultiEngine::defer(std::coroutine_handle<> coroutine) {
+		deferred_.push_back(coroutine);
+	}
+
+	void MultiEngine::configure(std::function<void(CURLM*)> configure) {
+		{
+			std::lock_guard lock(submit_mutex_);
+			configurations_.push_back(std::move(configure));
+		}
+		wake();
+	}
+
+	size_t MultiEngine::active_count() const noexcept {
+		return active_count_.load(std::memory_order_relaxed);
+	}
+
+	void MultiEngine::stop() {
+		stopping_ = true;
+		wake();
+	}
+
+	int MultiEngine::socket_callback(CURL*, curl_socket_t socket, int what, void* userp, void* socketp) {
+#if defined(__linux__)
+		auto* engine = static_cast<MultiEngine*>(userp);
+
+		if (what == CURL_POLL_REMOVE) {
+			// socket may be already closed, so the error is expected
+			epoll_ctl(engine->epoll_fd_, EPOLL_CTL_DEL, socket, nullptr);
+			return 0;
+		}
+
+		epoll_event event{};
+		event.events = ((what & CURL_POLL_IN) ? EPOLLIN : 0) | ((what & CURL_POLL_OUT) ? EPOLLOUT : 0);
+		event.data.fd = socket;
+
+		if (socketp) {
+			epoll_ctl(engine->epoll_fd_, EPOLL_CTL_MOD, socket, &event);
+		}
+		else {
+			epoll_ctl(engine->epoll_fd_, EPOLL_CTL_ADD, socket, &event);
+			curl_multi_assign(engine->multi_, socket, engine);
+		}
+#endif
+		return 0;
+	}
+
+	int MultiEngine::timer_callback(CURLM*, long timeout_ms, void* userp) {
+		auto* engine = static_cast<MultiEngine*>(userp);
+		engine->timeout_ms_ = timeout_ms;
+		if (timeout_ms >= 0) {
+			engine->timer_deadline_ = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeout_ms);
+		}
+		return 0;
+	}
+
+	void MultiEngine::wake() {
+#if defined(__linux__)
+		const uint64_t value = 1;
+		static_cast<void>(write(wake_fd_, &value, sizeof(value)));
+#else
+		curl_multi_wakeup(multi_);
+#endif
+	}
+
+	void MultiEngine::process_commands() {
+		std::vector<Transfer*> submitted;
+		std::vector<uint64_t> cancelled;
+		std::vector<uint64_t> unpaused;
+		std::vector<std::function<void(CURLM*)>> configurations;
+		{
+			std::lock_guard lock(submit_mutex_);
+			submitted.swap(submitted_);
+			cancelled.swap(cancelled_);
+			unpaused.swap(unpaused_);
+			configurations.swap(configurations_);
+		}
+
+		for (auto& configure : configurations) {
+			configure(multi_);
+		}
+
+		for (Transfer* transfer : submitted) {
+			curl_easy_setopt(transfer->easy, CURLOPT_PRIVATE, transfer);
+
+			if (curl_multi_add_handle(multi_, transfer->easy) != CURLM_OK) {
+				complete(transfer, CURLE_FAILED_INIT);
+				continue;
+			}
+			running_.emplace(transfer->id, transfer);
+
+			if (transfer->timeouts.first_byte.count() || transfer->timeouts.idle.count()) {
+				const auto now = std::chrono::steady_clock::now();
+				transfer->started = now;
+				transfer->last_activity = now;
+				transfer->first_byte_pending = transfer->timeouts.first_byte.count() != 0;
+				schedule_deadline(transfer, now);
+			}
+		}
+
+		for (uint64_t id : unpaused) {
+			auto iter = running_.find(id);
+			if (iter != running_.end()) {
+				// curl delivers paused data from inside the call
+				curl_easy_pause(iter->second->easy, CURLPAUSE_CONT);
+			}
+		}
+
+		for (uint64_t id : cancelled) {
+			auto iter = running_.find(id);
+			if (iter == running_.end()) {
+				// already done
+				continue;
+			}
+
+			Transfer* transfer = iter->second;
+			running_.erase(iter);
+			curl_multi_remove_handle(multi_, transfer->easy);
+			complete(transfer, CURLE_ABORTED_BY_CALLBACK);
+		}
+	}
+
+	void MultiEngine::check_completions() {
+		int queued = 0;
+		while (CURLMsg* message = curl_multi_info_read(multi_, &queued)) {
+			if (message->msg != CURLMSG_DONE) {
+				continue;
+			}
+
+			// message is invalidated by curl_multi_remove_handle
+			CURL* easy = message->easy_handle;
+			const CURLcode result = message->data.result;
+
+			char* transfer_ptr = nullptr;
+			curl_easy_getinfo(easy, CURLINFO_PRIVATE, &transfer_ptr);
+			auto* transfer = reinterpret_cast<Transfer*>(transfer_ptr);
+
+			curl_multi_remove_handle(multi_, easy);
+			running_.erase(transfer->id);
+			complete(transfer, result);
+		}
+	}
+
+	void MultiEngine::check_deadlines() {
+		const auto now = std::chrono::steady_clock::now();
+		while (!deadlines_.empty() && deadlines_.top().first <= now) {
+			const uint64_t id = deadlines_.top().second;
+			deadlines_.pop();
+
+			auto iter = running_.find(id);
+			if (iter == running_.end()) {
+				// already done
+				continue;
+			}
+
+			Transfer* transfer = iter->second;
+			const auto timeout = expired_timeout(transfer, now);
+			if (!timeout) {
+				schedule_deadline(transfer, now);
+				continue;
+			}
+
+			running_.erase(iter);
+			curl_multi_remove_handle(multi_, transfer->easy);
+			transfer->result.expired_timeout = timeout;
+			complete(transfer, TimeoutErrorCode);
+		}
+	}
+
+	void MultiEngine::schedule_deadline(Transfer* transfer, std::chrono::steady_clock::time_point now) {
+		using namespace std::chrono;
+
+		auto due = steady_clock::time_point::max();
+		if (transfer->first_byte_pending) {
+			due = std::min(due, transfer->started + transfer->timeouts.first_byte);
+		}
+		if (transfer->timeouts.idle.count()) {
+			// activity is noticed only on checks, so check twice per timeout
+			const auto check_interval = std::max(transfer->timeouts.idle / 2, milliseconds(1));
+			due = std::min({ due, transfer->last_activity + transfer->timeouts.idle, now + check_interval });
+		}
+
+		if (due != steady_clock::time_point::max()) {
+			deadlines_.emplace(due, transfer->id);
+		}
+	}
+
+	std::optional<TimeoutKind> MultiEngine::expired_timeout(Transfer* transfer, std::chrono::steady_clock::time_point now) const {
+		if (transfer->first_byte_pending) {
+			curl_off_t first_byte_time = 0;
+			curl_easy_getinfo(transfer->easy, CURLINFO_STARTTRANSFER_TIME_T, &first_byte_time);
+			if (first_byte_time != 0) {
+				transfer->first_byte_pending = false;
+			}
+			else if (now - transfer->started >= transfer->timeouts.first_byte) {
+				return TimeoutKind::FirstByte;
+			}
+		}
+
+		if (transfer->timeouts.idle.count()) {
+			curl_off_t downloaded = 0;
+			curl_off_t uploaded = 0;
+			curl_easy_getinfo(transfer->easy, CURLINFO_SIZE_DOWNLOAD_T, &downloaded);
+			curl_easy_getinfo(transfer->easy, CURLINFO_SIZE_UPLOAD_T, &uploaded);
+
+			if (downloaded + uploaded != transfer->transferred_bytes) {
+				transfer->transferred_bytes = downloaded + uploaded;
+				transfer->last_activity = now;
+			}
+			else if (now - transfer->last_activity >= transfer->timeouts.idle) {
+				return TimeoutKind::Idle;
+			}
+		}
+
+		return std::nullopt;
+	}
+
+	int MultiEngine::wait_timeout_ms() const {
+		using namespace std::chrono;
+
+		auto next = steady_clock::time_point::max();
+		if (timeout_ms_ >= 0) {
+			next = timer_deadline_;
+		}
+		if (!deadlines_.empty()) {
+			next = std::min(next, deadlines_.top().first);
+		}
+		if (next == steady_clock::time_point::max()) {
+			return -1;
+		}
+
+		const auto left = ceil<milliseconds>(next - steady_clock::now()).count();
+		return static_cast<int>(std::clamp<decltype(left)>(left, 0, std::numeric_limits<int>::max()));
+	}
+
+	void MultiEngine::complete(Transfer* transfer, CURLcode code) {
+		curl_easy_setopt(transfer->easy, CURLOPT_PRIVATE, nullptr);
+		active_count_.fetch_sub(1, std::memory_order_relaxed);
+
+		transfer->result.code = code;
+		if (!transfer->completions) {
+			transfer->continuation.resume();
+			return;
+		}
+
+		// the batch may be released by its consumer as soon as the last transfer is pushed, so the queue is kept until flush
+		const size_t index = transfer->index;
+		std::shared_ptr<CompletionQueue> completions = transfer->completions->shared_from_this();
+		if (pending_completions_.empty() || pending_completions_.back() != completions) {
+			pending_completions_.push_back(completions);
+		}
+		completions->push(index);
+	}
+
+	void MultiEngine::flush_completions() {
+		// consumer resumed by flush may submit new transfers, so the lists are swapped first
+		auto pending = std::move(pending_completions_);
+		pending_completions_.clear();
+		for (auto& completions : pending) {
+			completions->flush();
+		}
+
+		auto deferred = std::move(deferred_);
+		deferred_.clear();
+		for (auto coroutine : deferred) {
+			coroutine.resume();
+		}
+	}
+
+	void MultiEngine::complete_all(CURLcode code) {
+		process_commands();
+
+		auto running = std::move(running_);
+		for (auto& [id, transfer] : running) {
+			curl_multi_remove_handle(multi_, transfer->easy);
+			complete(transfer, code);
+		}
+		flush_completions();
+	}
+
+#if defined(__linux__)
+	void MultiEngine::run() {
+		while (!stopping_) {
+			run_once(wait_timeout_ms());
+		}
+
+		complete_all(CURLE_ABORTED_BY_CALLBACK);
+	}
+
+	coro::task<void> MultiEngine::drive(std::shared_ptr<MultiEngine> engine) {
+		using namespace std::chrono;
+
+		// the scheduler watches the loop epoll descriptor, which is readable when any socket or wake event is ready
+		while (!engine->stopping_) {
+			const int wait_ms = engine->wait_timeout_ms();
+			// zero poll timeout means infinite wait for the scheduler, so due timer only yields to other tasks
+			if (wait_ms != 0) {
+				co_await engine->scheduler_->poll(engine->epoll_fd_, coro::poll_op::read, milliseconds(std::max(wait_ms, 0)));
+			}
+			else {
+				co_await engine->scheduler_->yield();
+			}
+			engine->run_once(0);
+		}
+
+		engine->complete_all(CURLE_ABORTED_BY_CALLBACK);
+	}
+
+	void MultiEngine::run_once(const int timeout_ms) {
+		using namespace std::chrono;
+
+		std::array<epoll_event, 64> events;
+		int running_handles = 0;
+
+		const int count = epoll_wait(epoll_fd_, events.data(), static_cast<int>(events.size()), timeout_ms);
+		for (int i = 0; i < count; i++) {
+			const int fd = events[i].data.fd;
+			if (fd == wake_fd_) {
+				uint64_t value;
+				static_cast<void>(read(wake_fd_, &value, sizeof(value)));
+				continue;
+			}
+
+			int action = 0;
+			action |= (events[i].events & EPOLLIN) ? CURL_CSELECT_IN : 0;
+			action |= (events[i].events & EPOLLOUT) ? CURL_CSELECT_OUT : 0;
+			// hang-up may come without readable data, so it's reported like an error
+			action |= (events[i].events & (EPOLLERR | EPOLLHUP)) ? CURL_CSELECT_ERR : 0;
+			curl_multi_socket_action(multi_, fd, action, &running_handles);
+		}
+
+		process_commands();
+
+		if (timeout_ms_ >= 0 && steady_clock::now() >= timer_deadline_) {
+			timeout_ms_ = -1;
+			curl_multi_socket_action(multi_, CURL_SOCKET_TIMEOUT, 0, &running_handles);
+		}
+
+		check_completions();
+		check_deadlines();
+		flush_completions();
+	}
+#else
+	void MultiEngine::run() {
+		int running_handles = 0;
+
+		while (!stopping_) {
+			process_commands();
+			curl_multi_perform(multi_, &running_handles);
+			check_completions();
+			check_deadlines();
+			flush_completions();
+
+			const int wait_ms = wait_timeout_ms();
+			curl_multi_poll(multi_, nullptr, 0, wait_ms < 0 ? 1000 : std::min(wait_ms, 1000), nullptr);
+		}
+
+		complete_all(CURLE_ABORTED_BY_CALLBACK);
+	}
+#endif
+
+	EngineGroup::EngineGroup(const unsigned loop_count, const bool sharded) : sharded_(sharded) {
+		// process may be limited to some CPUs, like by taskset or cgroup cpuset
+		const std::vector<unsigned> cpus = sharded ? allowed_cpus() : std::vector<unsigned>();
+
+		engines_.reserve(loop_count);
+		for (unsigned i = 0; i < loop_count; i++) {
+			engines_.push_back(std::make_shared<MultiEngine>(sharded ? std::optional<unsigned>(cpus[i % cpus.size()]) : std::nullopt));
+		}
+	}
+
+#if defined(__linux__)
+	EngineGroup::EngineGroup(std::shared_ptr<coro::io_scheduler> scheduler) {
+		engines_.push_back(MultiEngine::make_shared(std::move(scheduler)));
+	}
+#endif
+
+	EngineGroup::~EngineGroup() {
+		// loops stop in parallel, then every thread is joined by the engine destructor
+		for (auto& engine : engines_) {
+			engine->stop();
+		}
+	}
+
+	MultiEngine& EngineGroup::pick() noexcept {
+		const size_t index = next_.fetch_add(1, std::memory_order_relaxed);
+		return *engines_[index % engines_.size()];
+	}
+
+	MultiEngine& EngineGroup::pick(std::string_view origin) noexcept {
+		if (!sharded_) {
+			return pick();
+		}
+
+		MultiEngine& home = home_engine(origin);
+
+		const size_t threshold = steal_threshold_.load(std::memory_order_relaxed);
+		if (threshold == no_stealing || home.active_count() < threshold) {
+			return home;
+		}
+
+		// start from different loops, so stealing requests don't pile up on the first idle one
+		const size_t start = next_.fetch_add(1, std::memory_order_relaxed);
+		for (size_t i = 0; i < engines_.size(); i++) {
+			MultiEngine& engine = *engines_[(start + i) % engines_.size()];
+			if (engine.active_count() == 0) {
+				return engine;
+			}
+		}
+		return home;
+	}
+
+	std::vector<MultiEngine*> EngineGroup::origin_engines(std::string_view origin) const {
+		if (sharded_) {
+			return { &home_engine(origin) };
+		}
+
+		std::vector<MultiEngine*> engines;
+		engines.reserve(engines_.size());
+		for (const auto& engine : engines_) {
+			engines.push_back(engine.get());
+		}
+		return engines;
+	}
+
+	void EngineGroup::set_work_stealing(const std::optional<size_t>& threshold) noexcept {
+		steal_threshold_.store(threshold.value_or(no_stealing), std::memory_order_relaxed);
+	}
+
+	MultiEngine& EngineGroup::home_engine(std::string_view origin) const noexcept {
+		return *engines_[std::hash<std::string_view>{}(origin) % engines_.size()];
+	}
+
+	bool EngineGroup::is_sharded() const noexcept {
+		return sharded_;
+	}
+
+	void EngineGroup::configure(const std::function<void(CURLM*)>& configure) {
+		for (auto& engine : engines_) {
+			engine->configure(configure);
+		}
+	}
+}
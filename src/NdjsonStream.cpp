@@ -0,0 +1,101 @@
+#include <asyncnet/NdjsonStream.hpp>
+
+#include <string_view>
+
+namespace asyncnet {
+
+	NdjsonDecoder::NdjsonDecoder(boost::json::storage_ptr storage) :
+		storage_(std::move(storage)),
+		parser_(std::make_unique<boost::json::stream_parser>())
+	{
+		parser_->reset(storage_);
+	}
+
+	void NdjsonDecoder::feed(std::string chunk) {
+		chunk_ = std::move(chunk);
+		offset_ = 0;
+	}
+
+	std::optional<boost::json::value> NdjsonDecoder::next() {
+		while (offset_ < chunk_.size()) {
+			const std::string_view rest = std::string_view(chunk_).substr(offset_);
+			const size_t newline = rest.find('\n');
+			const bool is_line_end = newline != std::string_view::npos;
+			const std::string_view part = rest.substr(0, newline);
+			offset_ = is_line_end ? offset_ + newline + 1 : chunk_.size();
+
+			if (is_skipping_) {
+				is_skipping_ = !is_line_end;
+				continue;
+			}
+
+			try {
+				// whitespace before record, like "\r" of empty line, isn't fed
+				if (has_record_ || part.find_first_not_of(" \t\r") != std::string_view::npos) {
+					has_record_ = true;
+					parser_->write(part.data(), part.size());
+				}
+				if (is_line_end && has_record_) {
+					return finish();
+				}
+			}
+			catch (...) {
+				reset();
+				is_skipping_ = !is_line_end;
+				throw;
+			}
+		}
+		return std::nullopt;
+	}
+
+	std::optional<boost::json::value> NdjsonDecoder::finish() {
+		if (!has_record_) {
+			return std::nullopt;
+		}
+
+		try {
+			parser_->finish();
+		}
+		catch (...) {
+			reset();
+			throw;
+		}
+		boost::json::value record = parser_->release();
+		reset();
+		return record;
+	}
+
+	void NdjsonDecoder::reset() noexcept {
+		parser_->reset(storage_);
+		has_record_ = false;
+	}
+
+	NdjsonStream::NdjsonStream(StreamingResponse&& response, boost::json::storage_ptr storage) :
+		response_(std::move(response)),
+		decoder_(std::move(storage))
+	{
+
+	}
+
+	coro::task<std::optional<boost::json::value>> NdjsonStream::next() {
+		while (true) {
+			if (auto record = decoder_.next()) {
+				co_return record;
+			}
+
+			auto chunk = co_await response_.next_chunk();
+			if (!chunk) {
+				co_return decoder_.finish();
+			}
+			decoder_.feed(std::move(*chunk));
+		}
+	}
+
+	long NdjsonStream::get_status_code() const {
+		return response_.get_status_code();
+	}
+
+	void NdjsonStream::request_stop() noexcept {
+		response_.request_stop();
+	}
+}
@@ -1,5 +1,7 @@
 #include <asyncnet/NetTypes.hpp>
 #include <curlpp/cURLpp.hpp>
+#include <algorithm>
+#include <cctype>
 
 namespace asyncnet {
 
@@ -62,7 +64,68 @@ namespace asyncnet {
         return curlpp::escape(tmp_str);
     }
 
+    std::string url_origin(std::string_view url) {
+        constexpr std::string_view scheme_delimiter = "://";
+
+        std::string_view scheme = "http";
+        const size_t scheme_end = url.find(scheme_delimiter);
+        if (scheme_end != std::string_view::npos) {
+            scheme = url.substr(0, scheme_end);
+            url.remove_prefix(scheme_end + scheme_delimiter.size());
+        }
+
+        std::string_view authority = url.substr(0, url.find_first_of("/?#"));
+        const size_t user_info_end = authority.rfind('@');
+        if (user_info_end != std::string_view::npos) {
+            authority.remove_prefix(user_info_end + 1);
+        }
+
+        std::string origin;
+        origin.reserve(scheme.size() + scheme_delimiter.size() + authority.size());
+        origin += scheme;
+        origin += scheme_delimiter;
+        origin += authority;
+        std::transform(origin.begin(), origin.end(), origin.begin(), [](unsigned char c) {
+            return static_cast<char>(std::tolower(c));
+        });
+        return origin;
+    }
+
+    boost::json::value parse_json(std::string_view str, boost::json::storage_ptr storage) {
+        // parser keeps its temporary buffers between calls
+        thread_local boost::json::parser parser;
+        parser.reset(std::move(storage));
+
+        boost::system::error_code error;
+        parser.write(str.data(), str.size(), error);
+        boost::json::value value = error ? boost::json::value() : parser.release();
+
+        // parser mustn't keep the storage of returned value alive
+        parser.reset();
+        if (error) {
+            throw boost::system::system_error(error);
+        }
+        return value;
+    }
+
     boost::json::object parse_json_object(std::string_view str) {
-        return boost::json::parse(str).as_object();
+        boost::json::value value = parse_json(str);
+        return std::move(value.as_object());
+    }
+
+    namespace detail {
+        std::string read_serializer(boost::json::serializer& serializer) {
+            constexpr size_t min_capacity = 256;
+
+            std::string text;
+            while (!serializer.done()) {
+                // output is read straight into free capacity of the text
+                const size_t offset = text.size();
+                text.resize(std::max(min_capacity, offset * 2));
+                const size_t read = serializer.read(text.data() + offset, text.size() - offset).size();
+                text.resize(offset + read);
+            }
+            return text;
+        }
     }
 };
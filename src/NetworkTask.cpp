@@ -50,6 +50,10 @@ namespace asyncnet {
 		bool Promise::request_stop() noexcept {
 			return stop_source_.request_stop();
 		}
+
+		std::stop_source Promise::get_stop_source() const noexcept {
+			return stop_source_;
+		}
 	}
 
 	NetworkTask::Awaitable::Awaitable(coroutine_handle coroutine) noexcept : coroutine_(coroutine) {
@@ -98,4 +102,8 @@ namespace asyncnet {
 	bool NetworkTask::request_stop() noexcept {
 		return coroutine_.promise().request_stop();
 	}
+
+	std::stop_source NetworkTask::get_stop_source() const noexcept {
+		return coroutine_.promise().get_stop_source();
+	}
 }
\ No newline at end of file
@@ -1,8 +1,40 @@
 #include <asyncnet/Request.hpp>
+#include <asyncnet/detail/Options.hpp>
 
 #include <curlpp/Options.hpp>
+#include <algorithm>
+#include <cctype>
 #include <ranges>
 
+namespace {
+	// 0 means no timeout for curl, so non-zero timeout is never rounded down to it
+	long timeout_milliseconds(const std::optional<std::chrono::system_clock::duration>& timeout) {
+		using namespace std::chrono;
+
+		if (!timeout || *timeout <= system_clock::duration::zero()) {
+			return 0;
+		}
+		return static_cast<long>(ceil<milliseconds>(*timeout).count());
+	}
+
+	std::optional<std::chrono::milliseconds> optional_timeout(const std::optional<std::chrono::system_clock::duration>& timeout) {
+		const long timeout_ms = timeout_milliseconds(timeout);
+		if (timeout_ms == 0) {
+			return std::nullopt;
+		}
+		return std::chrono::milliseconds(timeout_ms);
+	}
+
+	bool is_header(const std::string_view header, const std::string_view name) {
+		if (header.size() <= name.size() || header[name.size()] != ':') {
+			return false;
+		}
+		return std::ranges::equal(header.substr(0, name.size()), name, [](const char a, const char b) {
+			return std::tolower(static_cast<unsigned char>(a)) == std::tolower(static_cast<unsigned char>(b));
+		});
+	}
+}
+
 namespace asyncnet {
 
 	Request::Request() {
@@ -17,7 +49,7 @@ namespace asyncnet {
 		set_url(url);
 	}
 
-	Request::Request(const Request& other) {
+	Request::Request(const Request& other) : perform_options_(other.perform_options_) {
 		options_.reserve(other.options_.size());
 		for (auto& item : other.options_) {
 			options_.emplace_back(item->clone());
@@ -32,6 +64,10 @@ namespace asyncnet {
 		return handle;
 	}
 
+	const PerformOptions& Request::get_perform_options() const noexcept {
+		return perform_options_;
+	}
+
 	void Request::set_url(std::string_view url) {
 		base_url_ = url;
 		set_option<curlpp::options::Url>(base_url_);
@@ -43,10 +79,35 @@ namespace asyncnet {
 	}
 
 	void Request::set_timeout(const std::optional<std::chrono::system_clock::duration>& timeout) {
-		using namespace std::chrono;
+		set_option<detail::options::TimeoutMs>(timeout_milliseconds(timeout));
+	}
+
+	void Request::set_connect_timeout(const std::optional<std::chrono::system_clock::duration>& timeout) {
+		set_option<detail::options::ConnectTimeoutMs>(timeout_milliseconds(timeout));
+	}
+
+	void Request::set_first_byte_timeout(const std::optional<std::chrono::system_clock::duration>& timeout) {
+		perform_options_.first_byte_timeout = optional_timeout(timeout);
+	}
+
+	void Request::set_idle_timeout(const std::optional<std::chrono::system_clock::duration>& timeout) {
+		perform_options_.idle_timeout = optional_timeout(timeout);
+	}
 
-		const auto timeout_secs = duration_cast<seconds>(timeout.value_or(seconds(0))).count();
-		set_option<curlpp::options::Timeout>(timeout_secs);
+	void Request::set_priority(const RequestPriority priority) {
+		perform_options_.priority = priority;
+	}
+
+	void Request::set_tenant(const std::string& tenant) {
+		perform_options_.tenant = tenant;
+	}
+
+	void Request::set_body_mode(const ResponseBodyMode mode) {
+		perform_options_.body_mode = mode;
+	}
+
+	void Request::set_json_storage(const std::optional<boost::json::storage_ptr>& storage) {
+		perform_options_.json_storage = storage;
 	}
 
 	void Request::set_verbose(const bool& is_verbose) {
@@ -87,6 +148,37 @@ namespace asyncnet {
 		set_option<curlpp::options::CookieFile>(cookie_file);
 	}
 
+	void Request::set_http_version(const HttpVersion& version) {
+		long curl_version = CURL_HTTP_VERSION_NONE;
+		switch (version) {
+		case HttpVersion::Default:
+			curl_version = CURL_HTTP_VERSION_NONE;
+			break;
+		case HttpVersion::Http1_1:
+			curl_version = CURL_HTTP_VERSION_1_1;
+			break;
+		case HttpVersion::Http2:
+			curl_version = CURL_HTTP_VERSION_2TLS;
+			break;
+		case HttpVersion::Http2PriorKnowledge:
+			curl_version = CURL_HTTP_VERSION_2_PRIOR_KNOWLEDGE;
+			break;
+		}
+
+		const bool is_http2 = version == HttpVersion::Http2 || version == HttpVersion::Http2PriorKnowledge;
+		set_option<curlpp::options::HttpVersion>(curl_version);
+		set_option<detail::options::PipeWait>(is_http2);
+	}
+
+	void Request::set_expect_continue(const std::optional<std::chrono::system_clock::duration>& timeout) {
+		if (!timeout) {
+			// empty header removes the one curl adds
+			add_headers({ "Expect:" });
+			return;
+		}
+		set_option<detail::options::Expect100TimeoutMs>(timeout_milliseconds(timeout));
+	}
+
 	PostRequest::PostRequest(std::string_view url, const std::string& data) : Request(url) {
 		set_option<curlpp::options::PostFields>(data);
 		set_option<curlpp::options::PostFieldSizeLarge>(data.length());
@@ -98,6 +190,37 @@ namespace asyncnet {
 		set_option<curlpp::options::PostFieldSizeLarge>(data.length());
 	}
 
+	void JsonPostRequest::set_body(std::string body) {
+		const curl_off_t body_size = static_cast<curl_off_t>(body.size());
+		set_option<detail::options::SharedPostFields>(std::make_shared<const std::string>(std::move(body)));
+		set_option<curlpp::options::PostFieldSizeLarge>(body_size);
+
+		std::list<std::string> headers;
+		if (auto headers_option = get_option<curlpp::options::HttpHeader>()) {
+			headers = headers_option->getValue();
+			headers.remove_if([](const std::string& header) {
+				return is_header(header, "Content-Type");
+			});
+		}
+		headers.push_back("Content-Type: application/json");
+		set_headers(headers);
+	}
+
+	StreamingPostRequest::StreamingPostRequest(std::string_view url, BodySource source, const std::optional<curl_off_t>& content_length) : Request(url) {
+		set_source(std::move(source), content_length);
+	}
+
+	StreamingPostRequest::StreamingPostRequest(const Request& copy_request, std::string_view url, BodySource source, const std::optional<curl_off_t>& content_length) : Request(copy_request, url) {
+		set_source(std::move(source), content_length);
+	}
+
+	void StreamingPostRequest::set_source(BodySource source, const std::optional<curl_off_t>& content_length) {
+		// without post fields curl reads the body with read function, which is set by requestor. Unknown size -1 makes chunked HTTP/1.1 body
+		set_option<curlpp::options::Post>(true);
+		set_option<curlpp::options::PostFieldSizeLarge>(content_length.value_or(-1));
+		perform_options_.body_source = std::move(source);
+	}
+
 	HeadRequest::HeadRequest(std::string_view url) : Request(url) {
 		set_option<curlpp::options::NoBody>(true);
 	}
@@ -133,4 +256,12 @@ namespace asyncnet {
 			set_forms({ part });
 		}
 	}
+
+	WarmUpRequest::WarmUpRequest(const Request& copy_request, std::string_view origin) : Request(copy_request, origin) {
+		set_option<curlpp::options::CustomRequest>("OPTIONS");
+		set_option<detail::options::RequestTarget>("*");
+		set_option<curlpp::options::NoBody>(true);
+		set_option<curlpp::options::FreshConnect>(true);
+		set_option<detail::options::PipeWait>(false);
+	}
 }
@@ -1,67 +1,614 @@
 #include <asyncnet/Requestor.hpp>
+#include <asyncnet/detail/CancellableSchedule.hpp>
+#include <asyncnet/detail/JsonBodyParser.hpp>
+#include <asyncnet/detail/Options.hpp>
+#include <asyncnet/detail/UploadChannel.hpp>
 
 #include <curlpp/Options.hpp>
-#include <sstream>
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <optional>
+#include <unordered_map>
 
 constexpr int curl_cancel_request = 1;
 constexpr int curl_continue_request = 0;
+// bigger Content-Length isn't trusted to reserve memory at once
+constexpr curl_off_t max_reserved_body = 64 * 1024 * 1024;
 
-namespace asyncnet {
+namespace {
+	std::string handle_origin(const curlpp::Easy& handle) {
+		curlpp::options::Url url_option;
+		try {
+			handle.getOpt(url_option);
+		}
+		catch (const curlpp::UnsetOption&) {
+			return "";
+		}
+		return asyncnet::url_origin(url_option.getValue());
+	}
 
-	Requestor::Requestor(const unsigned worker_count) :
-		pool_(coro::thread_pool::make_shared(
-			coro::thread_pool::options {
-				.thread_count = worker_count
+	template<typename Option>
+	long option_or_zero(const curlpp::Easy& handle) {
+		Option option;
+		try {
+			handle.getOpt(option);
+		}
+		catch (const curlpp::UnsetOption&) {
+			return 0;
+		}
+		return option.getValue();
+	}
+
+	// curl reports both request and connect timeouts as CURLE_OPERATION_TIMEDOUT
+	asyncnet::TimeoutKind classify_timeout(const curlpp::Easy& handle) {
+		const long connect_timeout = option_or_zero<asyncnet::detail::options::ConnectTimeoutMs>(handle);
+		const long timeout = option_or_zero<asyncnet::detail::options::TimeoutMs>(handle);
+
+		curl_off_t pretransfer_time = 0;
+		curl_easy_getinfo(handle.getHandle(), CURLINFO_PRETRANSFER_TIME_T, &pretransfer_time);
+		const bool is_connecting = pretransfer_time == 0;
+
+		// both count from the start, so while connecting the shorter one fires
+		const bool is_connect_shorter = connect_timeout != 0 && (timeout == 0 || connect_timeout < timeout);
+		return is_connecting && is_connect_shorter ? asyncnet::TimeoutKind::Connect : asyncnet::TimeoutKind::Request;
+	}
+
+	/**
+	 * Write callback, which collects the body and reserves it by Content-Length on the first chunk
+	 */
+	curlpp::types::WriteFunctionFunctor body_writer(asyncnet::ResponseBody* body, CURL* easy) {
+		return [body, easy](char* data, size_t size, size_t count) {
+			if (body->empty()) {
+				curl_off_t content_length = -1;
+				curl_easy_getinfo(easy, CURLINFO_CONTENT_LENGTH_DOWNLOAD_T, &content_length);
+				if (content_length > 0) {
+					body->reserve(static_cast<size_t>(std::min(content_length, max_reserved_body)));
+				}
 			}
-		)),
-		after_pool_(coro::thread_pool::make_shared(
-			coro::thread_pool::options {
-				.thread_count = 1
+			body->append(data, size * count);
+			return size * count;
+		};
+	}
+
+	/**
+	 * Header callback, which captures headers of the final response
+	 */
+	curlpp::types::WriteFunctionFunctor header_writer(asyncnet::ResponseHeaders* headers) {
+		return [headers](char* data, size_t size, size_t count) {
+			headers->append_line(data, size * count);
+			return size * count;
+		};
+	}
+
+	/**
+	 * Checks Content-Type of the response. Body without Content-Type is expected to be JSON
+	 */
+	bool has_json_content_type(CURL* easy) {
+		const char* content_type = nullptr;
+		curl_easy_getinfo(easy, CURLINFO_CONTENT_TYPE, &content_type);
+		if (!content_type) {
+			return true;
+		}
+
+		const std::string_view header = content_type;
+		std::string media_type(header.substr(0, header.find(';')));
+		media_type.erase(media_type.find_last_not_of(" \t") + 1);
+		std::ranges::transform(media_type, media_type.begin(), [](const unsigned char c) { return static_cast<char>(std::tolower(c)); });
+		return media_type.ends_with("/json") || media_type.ends_with("+json");
+	}
+
+	/**
+	 * Write callback, which feeds the body to JSON parser on the transfer thread. Body of other Content-Type, like HTML error page, is kept as text
+	 */
+	curlpp::types::WriteFunctionFunctor json_writer(asyncnet::detail::JsonBodyParser* parser, asyncnet::ResponseBody* body, CURL* easy) {
+		return [parser, text_writer = body_writer(body, easy), easy, is_json = std::optional<bool>()](char* data, size_t size, size_t count) mutable {
+			if (!is_json) {
+				is_json = has_json_content_type(easy);
 			}
-		))
+			return *is_json ? parser->write(data, size * count) : text_writer(data, size, count);
+		};
+	}
+
+	boost::json::storage_ptr json_storage(const asyncnet::PerformOptions& options) {
+		// nodes of one document are bump-pointer allocated and freed at once with the document
+		return options.json_storage ? *options.json_storage : boost::json::make_shared_resource<boost::json::monotonic_resource>();
+	}
+
+	/**
+	 * Ends JSON parsing of done transfer
+	 * @param body Body kept as text, because it isn't JSON by Content-Type
+	 * @param json_error Set to parse error of invalid body, which doesn't fail the transfer, so its status is known
+	 * @return Returns parsed body or @ref std::nullopt if the transfer failed or body isn't parsed
+	 */
+	std::optional<boost::json::value> finish_json(asyncnet::detail::JsonBodyParser& parser, const asyncnet::ResponseBody& body, const std::exception_ptr& exception,
+		boost::system::error_code& json_error)
 	{
+		if (exception || !body.empty()) {
+			return std::nullopt;
+		}
+
+		boost::json::value json = parser.finish(json_error);
+		if (json_error) {
+			return std::nullopt;
+		}
+		return json;
+	}
+
+	std::exception_ptr make_network_error(const CURLcode code) {
+		return std::make_exception_ptr(asyncnet::NetworkRuntimeError(curl_easy_strerror(code), code));
+	}
+
+	/**
+	 * Makes error of failed transfer, telling which timeout expired
+	 * @param expired_timeout Timeout checked by asyncnet, which expired
+	 */
+	std::exception_ptr make_transfer_error(const curlpp::Easy& handle, const CURLcode code, const std::optional<asyncnet::TimeoutKind>& expired_timeout) {
+		if (expired_timeout) {
+			return std::make_exception_ptr(asyncnet::TimeoutError(*expired_timeout));
+		}
+		if (code == asyncnet::TimeoutErrorCode) {
+			return std::make_exception_ptr(asyncnet::TimeoutError(classify_timeout(handle)));
+		}
+		return make_network_error(code);
+	}
+
+	/**
+	 * Progress callback, which checks cancellation and timeouts curl_easy_perform can't check itself.
+	 * Curl calls it about once per second when nothing is transferred
+	 */
+	class ProgressWatchdog {
+	public:
+		explicit ProgressWatchdog(std::stop_token stop_token, CURL* easy, const asyncnet::PerformOptions& options, std::optional<asyncnet::TimeoutKind>* expired_timeout) :
+			stop_token_(std::move(stop_token)),
+			easy_(easy),
+			options_(options),
+			expired_timeout_(expired_timeout)
+		{
+
+		}
+
+		int operator()(double, double downloaded, double, double uploaded) {
+			using namespace std::chrono;
+
+			if (stop_token_.stop_requested()) {
+				return curl_cancel_request;
+			}
+
+			const auto now = steady_clock::now();
+			if (!started_) {
+				started_ = now;
+				last_activity_ = now;
+			}
+
+			if (options_.first_byte_timeout && !first_byte_received_) {
+				curl_off_t first_byte_time = 0;
+				curl_easy_getinfo(easy_, CURLINFO_STARTTRANSFER_TIME_T, &first_byte_time);
+				if (first_byte_time != 0) {
+					first_byte_received_ = true;
+				}
+				else if (now - *started_ >= *options_.first_byte_timeout) {
+					*expired_timeout_ = asyncnet::TimeoutKind::FirstByte;
+					return curl_cancel_request;
+				}
+			}
+
+			if (options_.idle_timeout) {
+				const double transferred = downloaded + uploaded;
+				if (transferred != transferred_bytes_) {
+					transferred_bytes_ = transferred;
+					last_activity_ = now;
+				}
+				else if (now - last_activity_ >= *options_.idle_timeout) {
+					*expired_timeout_ = asyncnet::TimeoutKind::Idle;
+					return curl_cancel_request;
+				}
+			}
+
+			return curl_continue_request;
+		}
 
+	private:
+		std::stop_token stop_token_;
+		CURL* easy_;
+		asyncnet::PerformOptions options_;
+		std::optional<asyncnet::TimeoutKind>* expired_timeout_;
+
+		std::optional<std::chrono::steady_clock::time_point> started_;
+		std::chrono::steady_clock::time_point last_activity_;
+		double transferred_bytes_ = 0;
+		bool first_byte_received_ = false;
+	};
+
+	struct UploadCanceller {
+		void operator()() const noexcept {
+			channel->cancel();
+		}
+
+		asyncnet::detail::UploadChannel* channel;
+	};
+
+	asyncnet::detail::DetachedTask stream_body(asyncnet::NetworkTask task, std::shared_ptr<asyncnet::detail::BodyChannel> body_channel) {
+		// the channel can be cancelled after the task is done, so the stop source is kept instead of the task
+		body_channel->set_stop_source(task.get_stop_source());
+		try {
+			const asyncnet::Response response = co_await std::move(task);
+			body_channel->close(nullptr, response.get_status_code());
+		}
+		catch (...) {
+			body_channel->close(std::current_exception());
+		}
+	}
+
+	asyncnet::detail::TransferTimeouts transfer_timeouts(const asyncnet::PerformOptions& options) {
+		using std::chrono::milliseconds;
+
+		return {
+			.first_byte = options.first_byte_timeout.value_or(milliseconds(0)),
+			.idle = options.idle_timeout.value_or(milliseconds(0))
+		};
 	}
 
-	Requestor::Requestor(const unsigned worker_count, std::shared_ptr<coro::thread_pool> executor_pool) :
-		pool_(coro::thread_pool::make_shared(
-			coro::thread_pool::options{
-				.thread_count = worker_count
+	/**
+	 * Batch driven by event loops directly, without coroutine per request
+	 */
+	class EngineBatch : public asyncnet::detail::ResponseBatch {
+	public:
+		explicit EngineBatch(std::vector<curlpp::Easy> handles, std::shared_ptr<asyncnet::ConnectionPool> connection_pool) :
+			ResponseBatch(handles.size()),
+			connection_pool_(std::move(connection_pool)),
+			handles_(std::move(handles)),
+			bodies_(handles_.size()),
+			headers_(handles_.size()),
+			json_parsers_(handles_.size()),
+			transfers_(handles_.size()),
+			engines_(handles_.size()),
+			leases_(handles_.size())
+		{
+
+		}
+
+		void start(asyncnet::detail::EngineGroup& engines, const std::vector<asyncnet::PerformOptions>& options) {
+			const bool needs_origin = connection_pool_ || engines.is_sharded();
+
+			// transfers are grouped by loop, so every loop is locked and woken once
+			std::unordered_map<asyncnet::detail::MultiEngine*, std::vector<asyncnet::detail::Transfer*>> loop_transfers;
+			for (size_t i = 0; i < handles_.size(); i++) {
+				curlpp::Easy& handle = handles_[i];
+				if (options[i].body_mode == asyncnet::ResponseBodyMode::Json) {
+					json_parsers_[i] = std::make_unique<asyncnet::detail::JsonBodyParser>(json_storage(options[i]));
+					handle.setOpt(curlpp::options::WriteFunction(json_writer(json_parsers_[i].get(), &bodies_[i], handle.getHandle())));
+				}
+				else {
+					handle.setOpt(curlpp::options::WriteFunction(body_writer(&bodies_[i], handle.getHandle())));
+				}
+				handle.setOpt(curlpp::options::HeaderFunction(header_writer(&headers_[i])));
+
+				const std::string origin = needs_origin ? handle_origin(handle) : std::string();
+				engines_[i] = &engines.pick(origin);
+				if (connection_pool_) {
+					leases_[i] = std::make_unique<asyncnet::ConnectionPool::Lease>(*connection_pool_, handle.getHandle(), origin, asyncnet::ConnectionPool::PerformMode::MultiHandle);
+				}
+
+				transfers_[i] = {
+					.easy = handle.getHandle(),
+					.timeouts = transfer_timeouts(options[i]),
+					.completions = &completions(),
+					.index = i
+				};
+
+				loop_transfers[engines_[i]].push_back(&transfers_[i]);
+			}
+
+			for (auto& [engine, transfers] : loop_transfers) {
+				engine->submit(transfers);
+			}
+		}
+
+		void request_stop() noexcept override {
+			for (size_t i = 0; i < transfers_.size(); i++) {
+				// done transfers are skipped by the loop
+				engines_[i]->cancel(&transfers_[i]);
+			}
+		}
+
+		asyncnet::BatchResult take(const size_t index) override {
+			curlpp::Easy& handle = handles_[index];
+			const asyncnet::detail::TransferResult& transfer_result = transfers_[index].result;
+
+			std::exception_ptr exception;
+			try {
+				handle.getCurlHandle().throwException();
+			}
+			catch (...) {
+				exception = std::current_exception();
+			}
+			if (!exception && transfer_result.code != CURLE_OK) {
+				exception = make_transfer_error(handle, transfer_result.code, transfer_result.expired_timeout);
+			}
+
+			std::optional<boost::json::value> json;
+			boost::system::error_code json_error;
+			if (json_parsers_[index]) {
+				json = finish_json(*json_parsers_[index], bodies_[index], exception, json_error);
+				json_parsers_[index].reset();
+			}
+
+			if (leases_[index]) {
+				leases_[index]->release(!exception);
+			}
+
+			asyncnet::BatchResult result{ .index = index };
+			if (exception) {
+				result.error = exception;
+			}
+			else if (json) {
+				result.response.emplace(std::move(handle), std::move(*json), std::move(headers_[index]));
+			}
+			else {
+				result.response.emplace(std::move(handle), std::move(bodies_[index]), std::move(headers_[index]), json_error);
 			}
-		)),
+			return result;
+		}
+
+	private:
+		// pool must outlive the leases
+		std::shared_ptr<asyncnet::ConnectionPool> connection_pool_;
+		std::vector<curlpp::Easy> handles_;
+		std::vector<asyncnet::ResponseBody> bodies_;
+		std::vector<asyncnet::ResponseHeaders> headers_;
+		std::vector<std::unique_ptr<asyncnet::detail::JsonBodyParser>> json_parsers_;
+		std::vector<asyncnet::detail::Transfer> transfers_;
+		std::vector<asyncnet::detail::MultiEngine*> engines_;
+		// leases are destroyed before the handles
+		std::vector<std::unique_ptr<asyncnet::ConnectionPool::Lease>> leases_;
+	};
+
+	/**
+	 * Batch of separate request tasks, which only gathers their completions
+	 */
+	class TaskBatch : public asyncnet::detail::ResponseBatch {
+	public:
+		explicit TaskBatch(std::vector<asyncnet::NetworkTask> tasks) :
+			ResponseBatch(tasks.size()),
+			tasks_(std::move(tasks)),
+			results_(tasks_.size())
+		{
+
+		}
+
+		static void start(const std::shared_ptr<TaskBatch>& batch) {
+			for (size_t i = 0; i < batch->tasks_.size(); i++) {
+				forward(batch, i);
+			}
+		}
+
+		void request_stop() noexcept override {
+			for (auto& task : tasks_) {
+				task.request_stop();
+			}
+		}
+
+		asyncnet::BatchResult take(const size_t index) override {
+			return std::move(results_[index]);
+		}
+
+	private:
+		static asyncnet::detail::DetachedTask forward(std::shared_ptr<TaskBatch> batch, const size_t index) {
+			asyncnet::BatchResult& result = batch->results_[index];
+			result.index = index;
+			try {
+				result.response.emplace(co_await std::move(batch->tasks_[index]));
+			}
+			catch (...) {
+				result.error = std::current_exception();
+			}
+
+			batch->completions_->push(index);
+			batch->completions_->flush();
+		}
+
+		std::vector<asyncnet::NetworkTask> tasks_;
+		std::vector<asyncnet::BatchResult> results_;
+	};
+}
+
+namespace asyncnet {
+
+	Requestor::Requestor(const unsigned worker_count, const RequestorEngine engine) :
+		Requestor(
+			worker_count,
+			// shards resume requests on own threads, so one shared thread doesn't become the bottleneck
+			engine == RequestorEngine::Sharded ? nullptr : coro::thread_pool::make_shared(
+				coro::thread_pool::options {
+					.thread_count = 1
+				}
+			),
+			engine
+		)
+	{
+
+	}
+
+	Requestor::Requestor(const unsigned worker_count, std::shared_ptr<coro::thread_pool> executor_pool, const RequestorEngine engine) :
 		after_pool_(executor_pool)
 	{
+		if (engine == RequestorEngine::EventLoop || engine == RequestorEngine::Sharded) {
+			engines_ = std::make_shared<detail::EngineGroup>(worker_count, engine == RequestorEngine::Sharded);
+		}
+		else {
+			pool_ = coro::thread_pool::make_shared(
+				coro::thread_pool::options {
+					.thread_count = worker_count
+				}
+			);
+			worker_limiter_ = std::make_shared<ConcurrencyLimiter>(
+				ConcurrencyLimiter::Options {
+					.max_in_flight = worker_count
+				}
+			);
+		}
+	}
+
+#if defined(__linux__)
+	Requestor::Requestor(std::shared_ptr<coro::io_scheduler> scheduler) :
+		engines_(std::make_shared<detail::EngineGroup>(std::move(scheduler)))
+	{
 
 	}
+#endif
 
-	NetworkTask Requestor::perform_handle(curlpp::Easy handle) const {
-		co_await pool_->schedule();
+	NetworkTask Requestor::perform_handle(curlpp::Easy handle, PerformOptions options) const {
+		return perform(std::move(handle), std::move(options), nullptr, nullptr);
+	}
+
+	NetworkTask Requestor::perform(curlpp::Easy handle, PerformOptions options, std::shared_ptr<detail::BodyChannel> body_channel, detail::MultiEngine* engine) const {
+		const std::stop_token stop_token = co_await NetworkTask::get_stop_token;
 
-		handle.setOpt(
-			curlpp::options::ProgressFunction([stop_token = co_await NetworkTask::get_stop_token](double, double, double, double) -> int {
-				return stop_token.stop_requested() ? curl_cancel_request : curl_continue_request;
-			})
-		);
+		// running blocking transfer can be stopped only from the progress callback, event loop checks timeouts itself
+		std::optional<TimeoutKind> expired_timeout;
+		handle.setOpt(curlpp::options::ProgressFunction(ProgressWatchdog(stop_token, handle.getHandle(), engines_ ? PerformOptions{} : options, &expired_timeout)));
 		handle.setOpt(curlpp::options::NoProgress(false));
 
-		std::ostringstream stream;
-		handle.setOpt(curlpp::options::WriteStream(&stream));
+		ResponseBody body;
+		std::optional<detail::JsonBodyParser> json_parser;
+		ResponseHeaders headers;
+		handle.setOpt(curlpp::options::HeaderFunction(header_writer(&headers)));
+		if (body_channel) {
+			handle.setOpt(curlpp::options::WriteFunction([channel = body_channel.get(), easy = handle.getHandle()](char* data, size_t size, size_t count) {
+				return channel->write(easy, data, size * count);
+			}));
+		}
+		else if (options.body_mode == ResponseBodyMode::Json) {
+			json_parser.emplace(json_storage(options));
+			handle.setOpt(curlpp::options::WriteFunction(json_writer(&*json_parser, &body, handle.getHandle())));
+		}
+		else {
+			handle.setOpt(curlpp::options::WriteFunction(body_writer(&body, handle.getHandle())));
+		}
+
+		// stop wakes worker blocked in the read callback and stops the producer
+		std::shared_ptr<detail::UploadChannel> upload_channel;
+		std::optional<std::stop_callback<UploadCanceller>> upload_stop_callback;
+		if (options.body_source) {
+			upload_channel = std::make_shared<detail::UploadChannel>(options.body_source);
+			handle.setOpt(curlpp::options::ReadFunction([channel = upload_channel.get(), easy = handle.getHandle()](char* buffer, size_t size, size_t count) {
+				return channel->read(easy, buffer, size * count);
+			}));
+			upload_stop_callback.emplace(stop_token, UploadCanceller{ upload_channel.get() });
+		}
+
+		// pool and limiter must outlive the lease and the permit
+		const auto connection_pool = connection_pool_;
+		const auto concurrency_limiter = concurrency_limiter_;
+		const bool needs_origin = connection_pool || concurrency_limiter || (engines_ && engines_->is_sharded());
+		const std::string origin = needs_origin ? handle_origin(handle) : std::string();
+
+		// waits for a slot before occupying a worker or an event loop
+		std::optional<ConcurrencyLimiter::Permit> permit;
+		if (concurrency_limiter) {
+			permit = co_await concurrency_limiter->acquire(origin, options.priority, options.tenant, stop_token);
+		}
+
+		// attached on the loop or the worker, which performs the transfer
+		std::optional<ConnectionPool::Lease> lease;
 
 		std::exception_ptr exception;
-		try {
-			handle.perform();
+		if (concurrency_limiter && !permit) {
+			// cancelled while waiting for a slot
+			exception = make_network_error(CancelledErrorCode);
 		}
-		catch (...) {
-			exception = std::current_exception();
+		else if (engines_) {
+			if (!engine) {
+				engine = &engines_->pick(origin);
+			}
+			if (connection_pool) {
+				lease.emplace(*connection_pool, handle.getHandle(), origin, ConnectionPool::PerformMode::MultiHandle);
+			}
+			if (body_channel) {
+				body_channel->attach(engine);
+			}
+			if (upload_channel) {
+				upload_channel->attach(engine);
+				upload_channel->start();
+			}
+
+			// resumed on the event loop thread, or at once on the thread requested stop
+			const detail::TransferResult result = co_await engine->perform(handle.getHandle(), stop_token, transfer_timeouts(options));
+			try {
+				handle.getCurlHandle().throwException();
+			}
+			catch (...) {
+				exception = std::current_exception();
+			}
+			if (!exception && result.code != CURLE_OK) {
+				exception = make_transfer_error(handle, result.code, result.expired_timeout);
+			}
+		}
+		else {
+			// limiter must outlive the permit, which passes the worker to the next request by priority
+			const auto worker_limiter = worker_limiter_;
+			const auto worker_permit = co_await worker_limiter->acquire(origin, options.priority, options.tenant, stop_token);
+
+			if (worker_permit && co_await detail::CancellableSchedule(pool_, stop_token)) {
+				if (connection_pool) {
+					lease.emplace(*connection_pool, handle.getHandle(), origin, ConnectionPool::PerformMode::Blocking);
+				}
+				if (upload_channel) {
+					upload_channel->start();
+				}
+
+				try {
+					handle.perform();
+				}
+				catch (const NetworkRuntimeError& error) {
+					const bool is_timeout = expired_timeout || error.whatCode() == TimeoutErrorCode;
+					exception = is_timeout ? make_transfer_error(handle, error.whatCode(), expired_timeout) : std::current_exception();
+				}
+				catch (...) {
+					exception = std::current_exception();
+				}
+			}
+			else {
+				// cancelled while waiting for a worker
+				exception = make_network_error(CancelledErrorCode);
+			}
+		}
+
+		if (upload_channel) {
+			// producer error aborts the transfer, so it's the real cause
+			upload_channel->cancel();
+			if (auto upload_error = upload_channel->error()) {
+				exception = upload_error;
+			}
+		}
+
+		std::optional<boost::json::value> json;
+		boost::system::error_code json_error;
+		if (json_parser) {
+			json = finish_json(*json_parser, body, exception, json_error);
 		}
 
+		if (lease) {
+			lease->release(!exception);
+		}
+
+		// next waiting request is resumed on this thread
+		permit.reset();
+
 		// user can pass custom pool with nullptr
 		if (after_pool_) {
 			co_await after_pool_->schedule();
 		}
 
 		if (!exception) {
-			co_return Response(std::move(handle), std::move(stream));
+			if (body_channel) {
+				co_return Response(std::move(handle));
+			}
+			if (json) {
+				co_return Response(std::move(handle), std::move(*json), std::move(headers));
+			}
+			co_return Response(std::move(handle), std::move(body), std::move(headers), json_error);
 		}
 
 		// handle throwed exception
@@ -69,7 +616,131 @@ namespace asyncnet {
 	}
 
 	NetworkTask Requestor::perform_request(const Request& request) const {
-		return perform_handle(request.make_request_handle());
+		return perform_handle(request.make_request_handle(), request.get_perform_options());
+	}
+
+	std::vector<NetworkTask> Requestor::perform_per_owner(const Request& request, const unsigned connections) const {
+		std::vector<NetworkTask> tasks;
+		if (!engines_) {
+			const size_t worker_count = pool_->thread_count();
+			tasks.reserve(worker_count);
+			for (size_t i = 0; i < worker_count; i++) {
+				tasks.push_back(perform_request(request));
+			}
+			return tasks;
+		}
+
+		const std::vector<detail::MultiEngine*> engines = engines_->origin_engines(handle_origin(request.make_request_handle()));
+		tasks.reserve(engines.size() * connections);
+		for (detail::MultiEngine* engine : engines) {
+			for (unsigned i = 0; i < connections; i++) {
+				tasks.push_back(perform(request.make_request_handle(), request.get_perform_options(), nullptr, engine));
+			}
+		}
+		return tasks;
+	}
+
+	StreamingResponse Requestor::perform_streaming(const Request& request, const size_t buffer_size) const {
+		auto body_channel = std::make_shared<detail::BodyChannel>(buffer_size);
+		stream_body(perform(request.make_request_handle(), request.get_perform_options(), body_channel, nullptr), body_channel);
+		return StreamingResponse(std::move(body_channel), after_pool_);
+	}
+
+	ResponseStream Requestor::perform_handles(std::vector<curlpp::Easy> handles, std::vector<PerformOptions> options) const {
+		// admission, blocking workers and body producers are handled per request, so such batch is made of separate request tasks
+		const bool has_body_source = std::ranges::any_of(options, [](const PerformOptions& request_options) {
+			return static_cast<bool>(request_options.body_source);
+		});
+		if (!engines_ || concurrency_limiter_ || has_body_source) {
+			std::vector<NetworkTask> tasks;
+			tasks.reserve(handles.size());
+			for (size_t i = 0; i < handles.size(); i++) {
+				tasks.push_back(perform_handle(std::move(handles[i]), std::move(options[i])));
+			}
+
+			auto batch = std::make_shared<TaskBatch>(std::move(tasks));
+			TaskBatch::start(batch);
+			// request tasks already switch to executor pool
+			return ResponseStream(std::move(batch), nullptr);
+		}
+
+		auto batch = std::make_shared<EngineBatch>(std::move(handles), connection_pool_);
+		batch->start(*engines_, options);
+		return ResponseStream(std::move(batch), after_pool_);
+	}
+
+	coro::task<std::vector<BatchResult>> Requestor::collect(ResponseStream stream) {
+		std::vector<BatchResult> results(stream.size());
+		while (!stream.done()) {
+			for (BatchResult& result : co_await stream.next()) {
+				// response isn't move assignable, so it's moved into place
+				BatchResult& slot = results[result.index];
+				slot.index = result.index;
+				slot.error = result.error;
+				if (result.response) {
+					slot.response.emplace(std::move(*result.response));
+				}
+			}
+		}
+		co_return results;
+	}
+
+	void Requestor::set_max_concurrent_streams(const long max_streams) {
+		if (!engines_) {
+			return;
+		}
+
+		engines_->configure([max_streams](CURLM* multi) {
+			curl_multi_setopt(multi, CURLMOPT_MAX_CONCURRENT_STREAMS, max_streams);
+		});
+	}
+
+	void Requestor::set_work_stealing(const std::optional<size_t>& threshold) {
+		if (engines_) {
+			engines_->set_work_stealing(threshold);
+		}
+	}
+
+	void Requestor::set_max_workers(const RequestPriority priority, const std::optional<size_t>& max_workers) {
+		if (!worker_limiter_) {
+			return;
+		}
+
+		worker_limiter_->set_priority_limit(priority, max_workers);
+	}
+
+	void Requestor::set_tenant_weight(const std::string& tenant, const unsigned weight) {
+		if (worker_limiter_) {
+			worker_limiter_->set_tenant_weight(tenant, weight);
+		}
+		if (concurrency_limiter_) {
+			concurrency_limiter_->set_tenant_weight(tenant, weight);
+		}
+	}
+
+	void Requestor::set_connection_pool(std::shared_ptr<ConnectionPool> connection_pool) {
+		connection_pool_ = std::move(connection_pool);
+		if (!engines_) {
+			return;
+		}
+
+		// multi handle ignores CURLOPT_MAXCONNECTS of its transfers, 0 restores curl default
+		const long max_connections = connection_pool_ ? connection_pool_->options().max_idle_connections : 0;
+		engines_->configure([max_connections](CURLM* multi) {
+			curl_multi_setopt(multi, CURLMOPT_MAXCONNECTS, max_connections);
+		});
+	}
+
+	const std::shared_ptr<ConnectionPool>& Requestor::get_connection_pool() const noexcept {
+		return connection_pool_;
+	}
+
+	void Requestor::set_concurrency_limiter(std::shared_ptr<ConcurrencyLimiter> concurrency_limiter) {
+		concurrency_limiter_ = std::move(concurrency_limiter);
+	}
+
+	const std::shared_ptr<ConcurrencyLimiter>& Requestor::get_concurrency_limiter() const noexcept {
+		return concurrency_limiter_;
 	}
 
 };
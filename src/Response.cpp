@@ -1,12 +1,28 @@
 #include <asyncnet/Response.hpp>
 
+#include <stdexcept>
+
 namespace asyncnet{
 	Response::Response(curlpp::Easy handle) : handle_(std::move(handle)) {
-
+		body_.finish();
 	}
 
-	Response::Response(curlpp::Easy handle, std::ostringstream&& stream) : handle_(std::move(handle)), stream_(std::move(stream)) {
+	Response::Response(curlpp::Easy handle, ResponseBody&& body, ResponseHeaders&& headers, const boost::system::error_code json_error) :
+		handle_(std::move(handle)),
+		body_(std::move(body)),
+		json_error_(json_error),
+		headers_(std::move(headers))
+	{
+		// slabs are kept, so the body is joined only if it's viewed as a whole
+		body_.finish();
+	}
 
+	Response::Response(curlpp::Easy handle, boost::json::value&& json, ResponseHeaders&& headers) :
+		handle_(std::move(handle)),
+		json_(std::move(json)),
+		headers_(std::move(headers))
+	{
+		body_.finish();
 	}
 
 	long Response::get_status_code() const {
@@ -16,11 +32,62 @@ namespace asyncnet{
 	}
 
 	std::string Response::get_text() const {
-		if (stream_) {
-			return stream_->str();
+		return std::string(body_.view());
+	}
+
+	std::string_view Response::get_text_view() const {
+		return body_.view();
+	}
+
+	const ResponseBody& Response::get_body() const noexcept {
+		return body_;
+	}
+
+	std::string Response::take_text() {
+		return body_.release();
+	}
+
+	boost::json::value Response::parse_json() const {
+		return parse_json(boost::json::make_shared_resource<boost::json::monotonic_resource>());
+	}
+
+	boost::json::value Response::parse_json(boost::json::storage_ptr storage) const {
+		return asyncnet::parse_json(body_.view(), std::move(storage));
+	}
+
+	std::vector<std::optional<boost::json::value>> Response::extract_json_fields(const std::vector<std::string>& pointers) const {
+		return asyncnet::extract_json_fields(body_.view(), pointers);
+	}
+
+	const boost::json::value& Response::get_json() const {
+		if (json_error_) {
+			throw boost::system::system_error(json_error_);
+		}
+		if (!json_) {
+			throw std::logic_error("response body isn't parsed as JSON, see Request::set_body_mode");
+		}
+		return *json_;
+	}
+
+	boost::json::value Response::take_json() {
+		if (json_error_) {
+			throw boost::system::system_error(json_error_);
 		}
-		else {
-			return "";
+		if (!json_) {
+			throw std::logic_error("response body isn't parsed as JSON, see Request::set_body_mode");
 		}
+		return std::move(*json_);
+	}
+
+	boost::system::error_code Response::get_json_error() const noexcept {
+		return json_error_;
+	}
+
+	const ResponseHeaders& Response::get_headers() const noexcept {
+		return headers_;
+	}
+
+	std::optional<std::string_view> Response::get_header(const std::string_view name) const {
+		return headers_.get(name);
 	}
 }
\ No newline at end of file
@@ -0,0 +1,330 @@
+#include <asyncnet/ResponseBody.hpp>
+
+#include <algorithm>
+#include <cstring>
+#include <mutex>
+#include <stdexcept>
+#include <utility>
+
+namespace {
+	using SlabData = std::unique_ptr<char[]>;
+
+	/**
+	 * Free slabs shared by every thread. Threads exchange slabs with it in batches through their own caches, so the lock is taken once per batch
+	 */
+	class SlabPool {
+	public:
+		/// Slabs moved between the pool and a thread cache at once
+		static constexpr size_t batch_size = 16;
+
+		static SlabPool& instance() {
+			static SlabPool pool;
+			return pool;
+		}
+
+		/**
+		 * Moves up to @ref batch_size free slabs to the cache
+		 */
+		void take(std::vector<SlabData>& slabs) {
+			std::lock_guard lock(mutex_);
+			const size_t count = std::min(batch_size, free_slabs_.size());
+			for (size_t i = 0; i < count; i++) {
+				slabs.push_back(std::move(free_slabs_.back()));
+				free_slabs_.pop_back();
+			}
+		}
+
+		/**
+		 * Moves the last count slabs of the cache into the pool
+		 */
+		void give(std::vector<SlabData>& slabs, const size_t count) noexcept {
+			std::lock_guard lock(mutex_);
+			for (size_t i = 0; i < count; i++) {
+				// memory above the limit is returned to the system
+				if (free_slabs_.size() < max_free_slabs) {
+					free_slabs_.push_back(std::move(slabs.back()));
+				}
+				slabs.pop_back();
+			}
+		}
+
+	private:
+		/// 16 MiB of slabs are kept for reuse, which covers a thousand of bodies up to a slab or a few big ones in flight
+		static constexpr size_t max_free_slabs = 1024;
+
+		SlabPool() {
+			free_slabs_.reserve(max_free_slabs);
+		}
+
+		std::mutex mutex_;
+		std::vector<SlabData> free_slabs_;
+	};
+
+	/**
+	 * Free slabs of one thread, which are taken and released without locking. Body is usually collected on the transfer thread
+	 * and released on the consumer thread, so caches exchange slabs through @ref SlabPool
+	 */
+	class SlabCache {
+	public:
+		static SlabCache& instance() {
+			thread_local SlabCache cache;
+			return cache;
+		}
+
+		SlabData acquire() {
+			if (free_slabs_.empty()) {
+				pool_.take(free_slabs_);
+			}
+			if (!free_slabs_.empty()) {
+				SlabData slab = std::move(free_slabs_.back());
+				free_slabs_.pop_back();
+				return slab;
+			}
+			return std::make_unique_for_overwrite<char[]>(asyncnet::ResponseBody::slab_size);
+		}
+
+		void release(SlabData slab) noexcept {
+			if (free_slabs_.size() == max_cached_slabs) {
+				pool_.give(free_slabs_, SlabPool::batch_size);
+			}
+			free_slabs_.push_back(std::move(slab));
+		}
+
+		~SlabCache() {
+			pool_.give(free_slabs_, free_slabs_.size());
+		}
+
+	private:
+		static constexpr size_t max_cached_slabs = 2 * SlabPool::batch_size;
+
+		// the pool is created first, so it outlives caches of every thread
+		SlabCache() : pool_(SlabPool::instance()) {
+			free_slabs_.reserve(max_cached_slabs);
+		}
+
+		SlabPool& pool_;
+		std::vector<SlabData> free_slabs_;
+	};
+}
+
+namespace asyncnet {
+
+	ResponseBody::ResponseBody(ResponseBody&& other) noexcept :
+		inline_data_(other.inline_data_),
+		is_inline_(std::exchange(other.is_inline_, true)),
+		size_(std::exchange(other.size_, 0)),
+		is_finished_(std::exchange(other.is_finished_, false)),
+		head_(std::move(other.head_)),
+		slabs_(std::move(other.slabs_)),
+		joined_(std::move(other.joined_)),
+		is_joined_(other.is_joined_.exchange(false))
+	{
+		other.head_.clear();
+		other.slabs_.clear();
+		other.joined_.clear();
+	}
+
+	ResponseBody& ResponseBody::operator=(ResponseBody&& other) noexcept {
+		if (this != &other) {
+			release_slabs();
+			inline_data_ = other.inline_data_;
+			is_inline_ = std::exchange(other.is_inline_, true);
+			size_ = std::exchange(other.size_, 0);
+			is_finished_ = std::exchange(other.is_finished_, false);
+			head_ = std::move(other.head_);
+			slabs_ = std::move(other.slabs_);
+			joined_ = std::move(other.joined_);
+			is_joined_ = other.is_joined_.exchange(false);
+			other.head_.clear();
+			other.slabs_.clear();
+			other.joined_.clear();
+		}
+		return *this;
+	}
+
+	ResponseBody::~ResponseBody() {
+		release_slabs();
+	}
+
+	void ResponseBody::reserve(const size_t capacity) {
+		if (size_ != 0 || capacity <= inline_capacity) {
+			return;
+		}
+		is_inline_ = false;
+		head_.reserve(capacity + tail_padding);
+	}
+
+	void ResponseBody::append(const char* data, size_t size) {
+		if (size == 0) {
+			return;
+		}
+		if (is_finished_) {
+			// padding of the head is dropped, inline padding is just overwritten
+			if (!is_inline_ && slabs_.empty()) {
+				head_.resize(size_);
+			}
+			is_finished_ = false;
+		}
+		reset_joined();
+
+		if (is_inline_) {
+			if (size_ + size <= inline_capacity) {
+				std::memcpy(inline_data_.data() + size_, data, size);
+				size_ += size;
+				return;
+			}
+			spill_inline();
+		}
+
+		// reserved head is filled without reallocation, leaving room for the padding, the rest goes to slabs
+		if (slabs_.empty()) {
+			const size_t room = head_.capacity() > head_.size() + tail_padding ? head_.capacity() - head_.size() - tail_padding : 0;
+			const size_t count = std::min(size, room);
+			head_.append(data, count);
+			data += count;
+			size -= count;
+			size_ += count;
+		}
+
+		while (size != 0) {
+			if (slabs_.empty() || slabs_.back().size == slab_size) {
+				slabs_.push_back({ .data = SlabCache::instance().acquire() });
+			}
+
+			Slab& slab = slabs_.back();
+			const size_t count = std::min(size, slab_size - slab.size);
+			std::memcpy(slab.data.get() + slab.size, data, count);
+			slab.size += count;
+			data += count;
+			size -= count;
+			size_ += count;
+		}
+	}
+
+	void ResponseBody::finish() {
+		if (is_finished_) {
+			return;
+		}
+
+		if (is_inline_) {
+			std::memset(inline_data_.data() + size_, 0, tail_padding);
+		}
+		else if (slabs_.empty()) {
+			head_.append(tail_padding, '\0');
+		}
+		is_finished_ = true;
+	}
+
+	size_t ResponseBody::size() const noexcept {
+		return size_;
+	}
+
+	bool ResponseBody::empty() const noexcept {
+		return size_ == 0;
+	}
+
+	std::string_view ResponseBody::view() const {
+		if (is_inline_) {
+			return std::string_view(inline_data_.data(), size_);
+		}
+		if (!slabs_.empty()) {
+			return joined_view();
+		}
+		return std::string_view(head_.data(), size_);
+	}
+
+	std::string_view ResponseBody::padded_view() const {
+		if (!is_finished_) {
+			throw std::logic_error("ResponseBody isn't finished");
+		}
+		return view();
+	}
+
+	std::vector<std::string_view> ResponseBody::chunks() const {
+		std::vector<std::string_view> result;
+		if (is_inline_) {
+			if (size_ != 0) {
+				result.emplace_back(inline_data_.data(), size_);
+			}
+			return result;
+		}
+
+		result.reserve(slabs_.size() + 1);
+		// padding is kept after the head only when there are no slabs
+		const size_t head_size = slabs_.empty() ? size_ : head_.size();
+		if (head_size != 0) {
+			result.emplace_back(head_.data(), head_size);
+		}
+		for (const Slab& slab : slabs_) {
+			result.emplace_back(slab.data.get(), slab.size);
+		}
+		return result;
+	}
+
+	std::string ResponseBody::release() {
+		std::string text;
+		if (is_inline_) {
+			text.assign(inline_data_.data(), size_);
+		}
+		else if (!slabs_.empty()) {
+			text = is_joined_.load(std::memory_order_acquire) ? std::move(joined_) : join();
+			text.resize(size_);
+			head_.clear();
+			release_slabs();
+		}
+		else {
+			head_.resize(size_);
+			text = std::move(head_);
+			head_.clear();
+		}
+
+		is_inline_ = true;
+		size_ = 0;
+		is_finished_ = false;
+		reset_joined();
+		return text;
+	}
+
+	void ResponseBody::spill_inline() {
+		Slab slab{ .data = SlabCache::instance().acquire(), .size = size_ };
+		std::memcpy(slab.data.get(), inline_data_.data(), size_);
+		slabs_.push_back(std::move(slab));
+		is_inline_ = false;
+	}
+
+	std::string_view ResponseBody::joined_view() const {
+		if (!is_joined_.load(std::memory_order_acquire)) {
+			std::lock_guard lock(join_mutex_);
+			if (!is_joined_.load(std::memory_order_relaxed)) {
+				joined_ = join();
+				is_joined_.store(true, std::memory_order_release);
+			}
+		}
+		return std::string_view(joined_.data(), size_);
+	}
+
+	std::string ResponseBody::join() const {
+		std::string text;
+		text.reserve(size_ + tail_padding);
+		text.append(head_);
+		for (const Slab& slab : slabs_) {
+			text.append(slab.data.get(), slab.size);
+		}
+		text.append(tail_padding, '\0');
+		return text;
+	}
+
+	void ResponseBody::reset_joined() noexcept {
+		if (is_joined_.load(std::memory_order_relaxed)) {
+			joined_ = std::string();
+			is_joined_.store(false, std::memory_order_relaxed);
+		}
+	}
+
+	void ResponseBody::release_slabs() noexcept {
+		for (Slab& slab : slabs_) {
+			SlabCache::instance().release(std::move(slab.data));
+		}
+		slabs_.clear();
+	}
+}
@@ -0,0 +1,168 @@
+#include <asyncnet/ResponseHeaders.hpp>
+
+#include <algorithm>
+#include <stdexcept>
+#include <utility>
+
+namespace {
+	constexpr std::array<std::pair<std::string_view, asyncnet::HeaderName>, 14> known_headers{ {
+		{ "Content-Type", asyncnet::HeaderName::ContentType },
+		{ "Content-Length", asyncnet::HeaderName::ContentLength },
+		{ "Content-Encoding", asyncnet::HeaderName::ContentEncoding },
+		{ "Transfer-Encoding", asyncnet::HeaderName::TransferEncoding },
+		{ "Location", asyncnet::HeaderName::Location },
+		{ "ETag", asyncnet::HeaderName::ETag },
+		{ "Last-Modified", asyncnet::HeaderName::LastModified },
+		{ "Cache-Control", asyncnet::HeaderName::CacheControl },
+		{ "Expires", asyncnet::HeaderName::Expires },
+		{ "Date", asyncnet::HeaderName::Date },
+		{ "Retry-After", asyncnet::HeaderName::RetryAfter },
+		{ "Set-Cookie", asyncnet::HeaderName::SetCookie },
+		{ "Connection", asyncnet::HeaderName::Connection },
+		{ "Server", asyncnet::HeaderName::Server }
+	} };
+
+	char ascii_lower(const char symbol) noexcept {
+		return symbol >= 'A' && symbol <= 'Z' ? static_cast<char>(symbol - 'A' + 'a') : symbol;
+	}
+
+	bool iequals(const std::string_view left, const std::string_view right) noexcept {
+		return std::ranges::equal(left, right, [](const char a, const char b) {
+			return ascii_lower(a) == ascii_lower(b);
+		});
+	}
+
+	std::optional<size_t> known_header_index(const std::string_view name) noexcept {
+		for (const auto& [known_name, header] : known_headers) {
+			if (known_name.size() == name.size() && iequals(known_name, name)) {
+				return static_cast<size_t>(header);
+			}
+		}
+		return std::nullopt;
+	}
+
+	std::string_view trim(std::string_view text) noexcept {
+		const auto is_space = [](const char symbol) {
+			return symbol == ' ' || symbol == '\t' || symbol == '\r' || symbol == '\n';
+		};
+		while (!text.empty() && is_space(text.front())) {
+			text.remove_prefix(1);
+		}
+		while (!text.empty() && is_space(text.back())) {
+			text.remove_suffix(1);
+		}
+		return text;
+	}
+}
+
+namespace asyncnet {
+
+	ResponseHeaders::ResponseHeaders() {
+		known_entries_.fill(no_entry);
+	}
+
+	void ResponseHeaders::append_line(const char* data, const size_t size) {
+		const std::string_view line(data, size);
+		if (line.starts_with("HTTP/")) {
+			clear();
+			return;
+		}
+		if (line.empty() || line.front() == ' ' || line.front() == '\t') {
+			return;
+		}
+
+		const size_t colon = line.find(':');
+		if (colon == std::string_view::npos) {
+			return;
+		}
+		const std::string_view name = trim(line.substr(0, colon));
+		const std::string_view value = trim(line.substr(colon + 1));
+		if (name.empty()) {
+			return;
+		}
+
+		// typical headers of one response fit without growing
+		if (arena_.capacity() == 0) {
+			arena_.reserve(1024);
+			entries_.reserve(16);
+		}
+
+		const Entry entry{
+			.name_offset = static_cast<uint32_t>(arena_.size()),
+			.name_size = static_cast<uint32_t>(name.size()),
+			.value_offset = static_cast<uint32_t>(arena_.size() + name.size()),
+			.value_size = static_cast<uint32_t>(value.size())
+		};
+		arena_.append(name);
+		arena_.append(value);
+
+		if (const auto known_index = known_header_index(name); known_index && known_entries_[*known_index] == no_entry) {
+			known_entries_[*known_index] = static_cast<uint32_t>(entries_.size());
+		}
+		entries_.push_back(entry);
+	}
+
+	size_t ResponseHeaders::size() const noexcept {
+		return entries_.size();
+	}
+
+	bool ResponseHeaders::empty() const noexcept {
+		return entries_.empty();
+	}
+
+	HeaderField ResponseHeaders::at(const size_t index) const {
+		if (index >= entries_.size()) {
+			throw std::out_of_range("header index is out of range");
+		}
+		return { .name = name_of(entries_[index]), .value = value_of(entries_[index]) };
+	}
+
+	std::optional<std::string_view> ResponseHeaders::get(const std::string_view name) const {
+		if (const auto known_index = known_header_index(name)) {
+			return get(static_cast<HeaderName>(*known_index));
+		}
+
+		for (const Entry& entry : entries_) {
+			if (entry.name_size == name.size() && iequals(name_of(entry), name)) {
+				return value_of(entry);
+			}
+		}
+		return std::nullopt;
+	}
+
+	std::optional<std::string_view> ResponseHeaders::get(const HeaderName name) const {
+		const uint32_t index = known_entries_[static_cast<size_t>(name)];
+		if (index == no_entry) {
+			return std::nullopt;
+		}
+		return value_of(entries_[index]);
+	}
+
+	std::vector<std::string_view> ResponseHeaders::get_all(const std::string_view name) const {
+		std::vector<std::string_view> values;
+		for (const Entry& entry : entries_) {
+			if (entry.name_size == name.size() && iequals(name_of(entry), name)) {
+				values.push_back(value_of(entry));
+			}
+		}
+		return values;
+	}
+
+	bool ResponseHeaders::contains(const std::string_view name) const {
+		return get(name).has_value();
+	}
+
+	void ResponseHeaders::clear() noexcept {
+		arena_.clear();
+		entries_.clear();
+		known_entries_.fill(no_entry);
+	}
+
+	std::string_view ResponseHeaders::name_of(const Entry& entry) const noexcept {
+		return std::string_view(arena_.data() + entry.name_offset, entry.name_size);
+	}
+
+	std::string_view ResponseHeaders::value_of(const Entry& entry) const noexcept {
+		return std::string_view(arena_.data() + entry.value_offset, entry.value_size);
+	}
+}
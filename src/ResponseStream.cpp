@@ -0,0 +1,67 @@
+#include <asyncnet/ResponseStream.hpp>
+
+namespace asyncnet {
+
+	detail::ResponseBatch::ResponseBatch(const size_t size) : completions_(std::make_shared<CompletionQueue>(size)) {
+
+	}
+
+	size_t detail::ResponseBatch::size() const noexcept {
+		return completions_->expected();
+	}
+
+	detail::CompletionQueue& detail::ResponseBatch::completions() noexcept {
+		return *completions_;
+	}
+
+	ResponseStream::ResponseStream(std::shared_ptr<detail::ResponseBatch> batch, std::shared_ptr<coro::thread_pool> after_pool) :
+		batch_(std::move(batch)),
+		after_pool_(std::move(after_pool))
+	{
+
+	}
+
+	ResponseStream::~ResponseStream() {
+		if (!batch_ || done()) {
+			return;
+		}
+
+		// requests still reference the batch, so it's released by the last of them
+		batch_->request_stop();
+		batch_->completions().keep_alive(batch_);
+	}
+
+	coro::task<std::vector<BatchResult>> ResponseStream::next() {
+		std::vector<BatchResult> results;
+		if (done()) {
+			co_return results;
+		}
+
+		const std::vector<size_t> indexes = co_await batch_->completions().wait();
+		results.reserve(indexes.size());
+		for (const size_t index : indexes) {
+			results.push_back(batch_->take(index));
+		}
+		taken_ += indexes.size();
+
+		// one switch for the whole batch of completions
+		if (after_pool_) {
+			co_await after_pool_->schedule();
+		}
+		co_return results;
+	}
+
+	size_t ResponseStream::size() const noexcept {
+		return batch_ ? batch_->size() : 0;
+	}
+
+	bool ResponseStream::done() const noexcept {
+		return taken_ == size();
+	}
+
+	void ResponseStream::request_stop() noexcept {
+		if (batch_) {
+			batch_->request_stop();
+		}
+	}
+}
@@ -0,0 +1,38 @@
+#include <asyncnet/StreamingResponse.hpp>
+
+namespace asyncnet {
+
+	StreamingResponse::StreamingResponse(std::shared_ptr<detail::BodyChannel> channel, std::shared_ptr<coro::thread_pool> after_pool) :
+		channel_(std::move(channel)),
+		after_pool_(std::move(after_pool))
+	{
+
+	}
+
+	StreamingResponse::~StreamingResponse() {
+		// transfer owns the channel too, so it's released when the transfer is done. Done transfer isn't affected
+		if (channel_) {
+			channel_->cancel();
+		}
+	}
+
+	coro::task<std::optional<std::string>> StreamingResponse::next_chunk() {
+		auto chunk = co_await channel_->read();
+
+		// the end of body is resumed on executor pool by the request itself
+		if (chunk && after_pool_) {
+			co_await after_pool_->schedule();
+		}
+		co_return chunk;
+	}
+
+	long StreamingResponse::get_status_code() const {
+		return channel_->status_code();
+	}
+
+	void StreamingResponse::request_stop() noexcept {
+		if (channel_) {
+			channel_->cancel();
+		}
+	}
+}
@@ -0,0 +1,181 @@
+#include <asyncnet/detail/UploadChannel.hpp>
+
+#include <algorithm>
+#include <cstring>
+#include <utility>
+
+namespace asyncnet::detail {
+
+	UploadChannel::SpaceAwaitable::SpaceAwaitable(UploadChannel& channel) noexcept : channel_(channel) {
+
+	}
+
+	bool UploadChannel::SpaceAwaitable::await_ready() const {
+		std::lock_guard lock(channel_.mutex_);
+		return channel_.cancelled_ || channel_.buffered_ < channel_.max_buffered_;
+	}
+
+	bool UploadChannel::SpaceAwaitable::await_suspend(std::coroutine_handle<> coroutine) {
+		std::lock_guard lock(channel_.mutex_);
+		if (channel_.cancelled_ || channel_.buffered_ < channel_.max_buffered_) {
+			return false;
+		}
+		channel_.waiter_ = coroutine;
+		return true;
+	}
+
+	bool UploadChannel::SpaceAwaitable::await_resume() const {
+		std::lock_guard lock(channel_.mutex_);
+		return !channel_.cancelled_;
+	}
+
+	UploadChannel::UploadChannel(BodySource source, const size_t max_buffered) :
+		source_(std::move(source)),
+		max_buffered_(max_buffered)
+	{
+
+	}
+
+	void UploadChannel::attach(MultiEngine* engine) noexcept {
+		engine_ = engine;
+	}
+
+	void UploadChannel::start() {
+		pump(shared_from_this());
+	}
+
+	size_t UploadChannel::read(CURL* easy, char* buffer, const size_t size) {
+		std::coroutine_handle<> waiter;
+		size_t copied = 0;
+		{
+			std::unique_lock lock(mutex_);
+			if (!engine_) {
+				data_.wait(lock, [this] {
+					return cancelled_ || finished_ || !chunks_.empty();
+				});
+			}
+
+			if (cancelled_ || error_) {
+				return CURL_READFUNC_ABORT;
+			}
+
+			while (copied < size && !chunks_.empty()) {
+				const std::string& chunk = chunks_.front();
+				const size_t count = std::min(size - copied, chunk.size() - offset_);
+				std::memcpy(buffer + copied, chunk.data() + offset_, count);
+				copied += count;
+				offset_ += count;
+
+				if (offset_ == chunk.size()) {
+					chunks_.pop_front();
+					offset_ = 0;
+				}
+			}
+
+			if (copied == 0) {
+				if (finished_) {
+					return 0;
+				}
+
+				// curl asks again after unpause
+				char* transfer = nullptr;
+				curl_easy_getinfo(easy, CURLINFO_PRIVATE, &transfer);
+				paused_id_ = reinterpret_cast<Transfer*>(transfer)->id;
+				return CURL_READFUNC_PAUSE;
+			}
+
+			buffered_ -= copied;
+			if (buffered_ < max_buffered_) {
+				waiter = std::exchange(waiter_, nullptr);
+			}
+		}
+
+		// user code must not run inside the loop callbacks
+		if (waiter && engine_) {
+			engine_->defer(waiter);
+		}
+		else if (waiter) {
+			waiter.resume();
+		}
+		return copied;
+	}
+
+	void UploadChannel::cancel() noexcept {
+		std::coroutine_handle<> waiter;
+		{
+			std::lock_guard lock(mutex_);
+			if (cancelled_) {
+				return;
+			}
+			cancelled_ = true;
+			paused_id_.reset();
+			waiter = std::exchange(waiter_, nullptr);
+		}
+		data_.notify_all();
+
+		if (waiter) {
+			waiter.resume();
+		}
+	}
+
+	std::exception_ptr UploadChannel::error() const {
+		std::lock_guard lock(mutex_);
+		return error_;
+	}
+
+	DetachedTask UploadChannel::pump(std::shared_ptr<UploadChannel> channel) {
+		try {
+			while (co_await channel->space()) {
+				auto chunk = co_await channel->source_();
+				if (!chunk) {
+					channel->finish(nullptr);
+					co_return;
+				}
+				channel->push(std::move(*chunk));
+			}
+		}
+		catch (...) {
+			channel->finish(std::current_exception());
+		}
+	}
+
+	UploadChannel::SpaceAwaitable UploadChannel::space() noexcept {
+		return SpaceAwaitable(*this);
+	}
+
+	void UploadChannel::push(std::string chunk) {
+		if (chunk.empty()) {
+			return;
+		}
+
+		std::optional<uint64_t> paused_id;
+		{
+			std::lock_guard lock(mutex_);
+			if (cancelled_) {
+				return;
+			}
+			buffered_ += chunk.size();
+			chunks_.push_back(std::move(chunk));
+			paused_id = std::exchange(paused_id_, std::nullopt);
+		}
+		unpause(paused_id);
+	}
+
+	void UploadChannel::finish(std::exception_ptr error) {
+		std::optional<uint64_t> paused_id;
+		{
+			std::lock_guard lock(mutex_);
+			finished_ = true;
+			error_ = error;
+			paused_id = std::exchange(paused_id_, std::nullopt);
+		}
+		unpause(paused_id);
+	}
+
+	void UploadChannel::unpause(std::optional<uint64_t> paused_id) {
+		data_.notify_all();
+		if (paused_id) {
+			engine_->unpause(*paused_id);
+		}
+	}
+}
@@ -0,0 +1,214 @@
+#include "catch_amalgamated.hpp"
+
+#include <asyncnet/AsyncSession.hpp>
+#include <asyncnet/ConcurrencyLimiter.hpp>
+#include <asyncnet/detail/CancellableSchedule.hpp>
+
+#include <coro/sync_wait.hpp>
+#include <coro/when_all.hpp>
+#include <map>
+
+#pragma execution_character_set("utf-8")
+
+using namespace asyncnet;
+
+namespace {
+	struct Acquirer {
+		ConcurrencyLimiter& limiter;
+		std::vector<int> order;
+		std::map<int, ConcurrencyLimiter::Permit> permits;
+
+		// negative id means cancelled
+		detail::DetachedTask acquire(std::string origin, int id, std::stop_token stop_token = {}, RequestPriority priority = RequestPriority::Normal, std::string tenant = {}) {
+			auto permit = co_await limiter.acquire(origin, priority, tenant, stop_token);
+			if (!permit) {
+				order.push_back(-id);
+				co_return;
+			}
+
+			order.push_back(id);
+			permits.emplace(id, std::move(*permit));
+		}
+
+		// releasing resumes next waiters, which add their permits
+		void release(int id) {
+			auto node = permits.extract(id);
+			node.mapped().release();
+		}
+
+		void release_all() {
+			auto released = std::move(permits);
+			permits.clear();
+			released.clear();
+		}
+	};
+}
+
+TEST_CASE("ConcurrencyLimiter per host limit") {
+	ConcurrencyLimiter limiter({
+		.max_in_flight = 3,
+		.max_in_flight_per_host = 2
+	});
+	Acquirer acquirer{ limiter };
+
+	acquirer.acquire("https://a.com", 1);
+	acquirer.acquire("https://a.com", 2);
+	acquirer.acquire("https://a.com", 3);
+	acquirer.acquire("https://a.com", 4);
+	// isn't blocked by waiting requests to another origin
+	acquirer.acquire("https://b.com", 5);
+	acquirer.acquire("https://b.com", 6);
+
+	REQUIRE(acquirer.order == std::vector<int>{ 1, 2, 5 });
+	REQUIRE(limiter.in_flight() == 3);
+	REQUIRE(limiter.queued() == 3);
+
+	// the oldest waiter of origin with free slot goes first
+	acquirer.release(1);
+	REQUIRE(acquirer.order.back() == 3);
+
+	acquirer.release(5);
+	REQUIRE(acquirer.order.back() == 6);
+
+	acquirer.release_all();
+	REQUIRE(acquirer.order.back() == 4);
+
+	acquirer.release_all();
+	REQUIRE(limiter.in_flight() == 0);
+	REQUIRE(limiter.queued() == 0);
+}
+
+TEST_CASE("ConcurrencyLimiter cancellation") {
+	ConcurrencyLimiter limiter({
+		.max_in_flight = 1
+	});
+	Acquirer acquirer{ limiter };
+
+	acquirer.acquire("https://a.com", 1);
+
+	std::stop_source waiting_stop;
+	acquirer.acquire("https://a.com", 2, waiting_stop.get_token());
+	REQUIRE(limiter.queued() == 1);
+
+	waiting_stop.request_stop();
+	REQUIRE(acquirer.order.back() == -2);
+	REQUIRE(limiter.queued() == 0);
+
+	std::stop_source stopped;
+	stopped.request_stop();
+	acquirer.acquire("https://a.com", 3, stopped.get_token());
+	REQUIRE(acquirer.order.back() == -3);
+
+	acquirer.release_all();
+	REQUIRE(limiter.in_flight() == 0);
+}
+
+TEST_CASE("ConcurrencyLimiter priorities") {
+	ConcurrencyLimiter limiter({
+		.max_in_flight = 2,
+		.max_in_flight_per_priority = { std::nullopt, std::nullopt, 1 }
+	});
+	Acquirer acquirer{ limiter };
+
+	acquirer.acquire("https://a.com", 1, {}, RequestPriority::Bulk);
+	// bulk share is capped
+	acquirer.acquire("https://a.com", 2, {}, RequestPriority::Bulk);
+	acquirer.acquire("https://a.com", 3, {}, RequestPriority::Normal);
+	acquirer.acquire("https://a.com", 4, {}, RequestPriority::Normal);
+	acquirer.acquire("https://b.com", 5, {}, RequestPriority::Interactive);
+
+	REQUIRE(acquirer.order == std::vector<int>{ 1, 3 });
+	REQUIRE(limiter.in_flight(RequestPriority::Bulk) == 1);
+
+	// higher priority goes first despite arrival order
+	acquirer.release(1);
+	REQUIRE(acquirer.order.back() == 5);
+
+	acquirer.release(3);
+	REQUIRE(acquirer.order.back() == 4);
+
+	acquirer.release(5);
+	REQUIRE(acquirer.order.back() == 2);
+
+	acquirer.release_all();
+	REQUIRE(limiter.in_flight() == 0);
+	REQUIRE(limiter.queued() == 0);
+}
+
+TEST_CASE("ConcurrencyLimiter priority limit change") {
+	ConcurrencyLimiter limiter({
+		.max_in_flight_per_priority = { std::nullopt, std::nullopt, 0 }
+	});
+	Acquirer acquirer{ limiter };
+
+	acquirer.acquire("https://a.com", 1, {}, RequestPriority::Bulk);
+	REQUIRE(acquirer.order.empty());
+
+	limiter.set_priority_limit(RequestPriority::Bulk, std::nullopt);
+	REQUIRE(acquirer.order == std::vector<int>{ 1 });
+
+	acquirer.release_all();
+}
+
+TEST_CASE("ConcurrencyLimiter tenants") {
+	ConcurrencyLimiter limiter({
+		.max_in_flight = 1,
+		.tenant_weights = {
+			{ "big", 2 }
+		}
+	});
+	Acquirer acquirer{ limiter };
+
+	acquirer.acquire("https://a.com", 100, {}, RequestPriority::Normal, "noisy");
+	// noisy tenant fills the queue first
+	for (int i = 1; i <= 6; i++) {
+		acquirer.acquire("https://a.com", i, {}, RequestPriority::Normal, "noisy");
+	}
+	acquirer.acquire("https://b.com", 11, {}, RequestPriority::Normal, "big");
+	acquirer.acquire("https://b.com", 12, {}, RequestPriority::Normal, "big");
+	acquirer.acquire("https://b.com", 13, {}, RequestPriority::Normal, "big");
+	acquirer.acquire("https://c.com", 21, {}, RequestPriority::Normal, "small");
+
+	REQUIRE(acquirer.order == std::vector<int>{ 100 });
+
+	for (int id : { 100, 1, 11, 12, 21, 2, 13 }) {
+		acquirer.release(id);
+	}
+
+	// every tenant gets slots by its weight in turn, the rest goes to the only waiting tenant
+	REQUIRE(acquirer.order == std::vector<int>{ 100, 1, 11, 12, 21, 2, 13, 3 });
+
+	acquirer.release(3);
+	REQUIRE(acquirer.order.back() == 4);
+
+	acquirer.release_all();
+	acquirer.release_all();
+	acquirer.release_all();
+	REQUIRE(limiter.in_flight() == 0);
+	REQUIRE(limiter.queued() == 0);
+}
+
+#ifdef ASYNCNET_ENABLE_TESTS_NETWORK
+
+TEST_CASE("AsyncSession concurrency limits") {
+	AsyncSession session(1, RequestorEngine::EventLoop);
+	session.set_concurrency_limits({
+		.max_in_flight_per_host = 2
+	});
+
+	auto worker = [](AsyncSession& session) -> coro::task<void> {
+		auto resp = co_await session.perform_request(session.make_request<GetRequest>("https://httpbin.org/get"));
+		REQUIRE(resp.get_status_code() == 200);
+		REQUIRE(session.get_concurrency_limiter()->in_flight() <= 2);
+	};
+
+	std::vector<coro::task<void>> tasks;
+	for (int i = 0; i < 6; i++) {
+		tasks.push_back(worker(session));
+	}
+	coro::sync_wait(coro::when_all(std::move(tasks)));
+
+	REQUIRE(session.get_concurrency_limiter()->in_flight() == 0);
+}
+
+#endif
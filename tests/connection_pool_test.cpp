@@ -0,0 +1,119 @@
+#include "catch_amalgamated.hpp"
+
+#include <asyncnet/AsyncSession.hpp>
+#include <asyncnet/ConnectionPool.hpp>
+
+#include <coro/sync_wait.hpp>
+#include <coro/when_all.hpp>
+
+#include <thread>
+#include <vector>
+
+#pragma execution_character_set("utf-8")
+
+using namespace asyncnet;
+
+TEST_CASE("ConnectionPool lease attach, release") {
+	ConnectionPool pool;
+	CURL* easy = curl_easy_init();
+
+	{
+		ConnectionPool::Lease lease(pool, easy, url_origin("https://httpbin.org/get"), ConnectionPool::PerformMode::Blocking);
+		REQUIRE(pool.origins_count() == 1);
+	}
+	{
+		ConnectionPool::Lease lease(pool, easy, url_origin("https://httpbin.org/post"), ConnectionPool::PerformMode::Blocking);
+		lease.release(false);
+		REQUIRE(pool.origins_count() == 1);
+	}
+	{
+		// every thread has its own cache of the origin
+		std::thread thread([&pool]() {
+			CURL* thread_easy = curl_easy_init();
+			ConnectionPool::Lease lease(pool, thread_easy, url_origin("https://httpbin.org/get"), ConnectionPool::PerformMode::Blocking);
+			lease.release(false);
+			curl_easy_cleanup(thread_easy);
+		});
+		thread.join();
+		REQUIRE(pool.origins_count() == 2);
+	}
+	{
+		// multi handle keeps connections itself
+		ConnectionPool::Lease lease(pool, easy, url_origin("https://example.com/"), ConnectionPool::PerformMode::MultiHandle);
+		REQUIRE(pool.origins_count() == 2);
+	}
+
+	const auto statistics = pool.statistics();
+	REQUIRE(statistics.connection_hits == 0);
+	REQUIRE(statistics.connection_misses == 0);
+
+	curl_easy_cleanup(easy);
+}
+
+TEST_CASE("ConnectionPool evicts idle origins") {
+	ConnectionPool pool(ConnectionPool::Options{ .idle_timeout = std::chrono::seconds(0) });
+	CURL* easy = curl_easy_init();
+	CURL* other_easy = curl_easy_init();
+
+	{
+		ConnectionPool::Lease lease(pool, easy, url_origin("https://httpbin.org/get"), ConnectionPool::PerformMode::Blocking);
+		// cache with attached handle is kept
+		ConnectionPool::Lease other_lease(pool, other_easy, url_origin("https://example.com/"), ConnectionPool::PerformMode::Blocking);
+		REQUIRE(pool.origins_count() == 2);
+	}
+
+	ConnectionPool::Lease lease(pool, easy, url_origin("https://example.com/"), ConnectionPool::PerformMode::Blocking);
+	REQUIRE(pool.origins_count() == 1);
+
+	lease.release(false);
+	curl_easy_cleanup(other_easy);
+	curl_easy_cleanup(easy);
+}
+
+#ifdef ASYNCNET_ENABLE_TESTS_NETWORK
+
+TEST_CASE("AsyncSession reuses connection") {
+	AsyncSession session(1);
+
+	auto worker = [](AsyncSession& session) -> coro::task<void> {
+		for (int i = 0; i < 3; i++) {
+			auto resp = co_await session.perform_request(session.make_request<GetRequest>("https://httpbin.org/get"));
+			REQUIRE(resp.get_status_code() == 200);
+		}
+	};
+
+	coro::sync_wait(worker(session));
+
+	const auto statistics = session.get_connection_pool()->statistics();
+	REQUIRE(statistics.connection_misses == 1);
+	REQUIRE(statistics.connection_hits == 2);
+	REQUIRE(statistics.dns_misses == 1);
+	// resumption is counted only with OpenSSL backend
+	REQUIRE(statistics.tls_session_cache_hits == 0);
+	REQUIRE(statistics.tls_session_cache_misses <= 1);
+}
+
+TEST_CASE("AsyncSession shares DNS cache between loops") {
+	const auto engine = GENERATE(RequestorEngine::EventLoop, RequestorEngine::Sharded);
+	AsyncSession session(4, engine);
+
+	auto get = [](AsyncSession& session) -> coro::task<void> {
+		auto resp = co_await session.perform_request(session.make_request<GetRequest>("https://httpbin.org/get"));
+		REQUIRE(resp.get_status_code() == 200);
+	};
+
+	// the first request fills the cache, so parallel requests don't resolve the name at once
+	coro::sync_wait(get(session));
+
+	std::vector<coro::task<void>> tasks;
+	for (int i = 0; i < 8; i++) {
+		tasks.push_back(get(session));
+	}
+	coro::sync_wait(coro::when_all(std::move(tasks)));
+
+	const auto statistics = session.get_connection_pool()->statistics();
+	REQUIRE(statistics.dns_misses == 1);
+	REQUIRE(statistics.connection_hits + statistics.connection_misses == 9);
+}
+
+#endif
\ No newline at end of file
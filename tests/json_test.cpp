@@ -1,12 +1,75 @@
 #include "catch_amalgamated.hpp"
+#include <asyncnet/JsonBodySource.hpp>
 #include <asyncnet/JsonConversions.hpp>
+#include <asyncnet/JsonFieldExtractor.hpp>
+#include <asyncnet/JsonView.hpp>
+#include <asyncnet/NdjsonStream.hpp>
+#include <asyncnet/NetTypes.hpp>
+#include <asyncnet/detail/JsonBodyParser.hpp>
+#include <coro/sync_wait.hpp>
+
+#include <cstdlib>
+#include <new>
 
 #pragma execution_character_set("utf-8")
 
+namespace {
+	/// Count of allocations made on the thread
+	thread_local size_t allocation_count = 0;
+}
+
+// counts allocations, so tests can check that no DOM is built
+void* operator new(size_t size) {
+	allocation_count++;
+	if (void* memory = std::malloc(size == 0 ? 1 : size)) {
+		return memory;
+	}
+	throw std::bad_alloc();
+}
+
+void operator delete(void* memory) noexcept {
+	std::free(memory);
+}
+
+void operator delete(void* memory, size_t) noexcept {
+	std::free(memory);
+}
+
 namespace boost::json {
 	using asyncnet::json::timestamp::tag_invoke;
 };
 
+namespace {
+	struct Item {
+		int id = 0;
+		std::string name;
+		std::optional<double> score;
+	};
+	BOOST_DESCRIBE_STRUCT(Item, (), (id, name, score))
+
+	struct Event {
+		std::vector<Item> items;
+		std::chrono::seconds duration{};
+	};
+	BOOST_DESCRIBE_STRUCT(Event, (), (items, duration))
+
+	struct RawEvent {
+		std::string type;
+		boost::json::value payload;
+	};
+	BOOST_DESCRIBE_STRUCT(RawEvent, (), (type, payload))
+
+	struct Tag {
+		std::string name;
+	};
+	BOOST_DESCRIBE_STRUCT(Tag, (), (name))
+
+	// tag is sent as plain string
+	Tag tag_invoke(boost::json::value_to_tag<Tag>, const boost::json::value& json) {
+		return Tag{ .name = std::string(json.as_string()) };
+	}
+}
+
 TEST_CASE("asyncnet::json to/from time_point") {
 	using UnsignedTimePoint = std::chrono::time_point<std::chrono::system_clock, std::chrono::duration<unsigned long long>>;
 	using TimePoint = std::chrono::time_point<std::chrono::system_clock, std::chrono::seconds>;
@@ -45,4 +108,272 @@ TEST_CASE("asyncnet::json to/from duration") {
 	REQUIRE_THROWS_AS(boost::json::value_to<std::chrono::seconds>(json_value_null), boost::system::system_error);
 
 	REQUIRE(boost::json::value_from(std::chrono::seconds(13)) == json_value);
-}
\ No newline at end of file
+}
+
+TEST_CASE("asyncnet::json body parser") {
+	SECTION("chunks") {
+		asyncnet::detail::JsonBodyParser parser({});
+		REQUIRE(parser.write("{\"a\": [1, ", 10) == 10);
+		REQUIRE(parser.write("2], \"b\"", 7) == 7);
+		REQUIRE(parser.write(": \"c\"}", 6) == 6);
+		REQUIRE_FALSE(parser.failed());
+		REQUIRE(parser.finish() == boost::json::parse(R"({"a": [1, 2], "b": "c"})"));
+	}
+
+	SECTION("empty body") {
+		asyncnet::detail::JsonBodyParser parser({});
+		REQUIRE(parser.finish().is_null());
+	}
+
+	SECTION("invalid") {
+		asyncnet::detail::JsonBodyParser parser({});
+		// the rest of body is skipped, so the transfer isn't failed
+		REQUIRE(parser.write("{]", 2) == 2);
+		REQUIRE(parser.write("[1]", 3) == 3);
+		REQUIRE(parser.failed());
+		REQUIRE_THROWS_AS(parser.finish(), boost::system::system_error);
+	}
+
+	SECTION("incomplete") {
+		asyncnet::detail::JsonBodyParser parser({});
+		REQUIRE(parser.write("[1, 2", 5) == 5);
+
+		boost::system::error_code error;
+		REQUIRE(parser.finish(error).is_null());
+		REQUIRE(error);
+	}
+}
+
+TEST_CASE("asyncnet::json parse as") {
+	static_assert(asyncnet::detail::parse_into_supported<std::vector<Item>>);
+	static_assert(!asyncnet::detail::parse_into_supported<Event>);
+
+	// parsed without DOM
+	const auto items = asyncnet::parse_json_as<std::vector<Item>>(R"([{"id": 1, "name": "a", "score": 0.5}, {"id": 2, "name": "b", "score": null}])");
+	REQUIRE(items.size() == 2);
+	REQUIRE(items[0].id == 1);
+	REQUIRE(items[0].name == "a");
+	REQUIRE(items[0].score == 0.5);
+	REQUIRE(items[1].id == 2);
+	REQUIRE_FALSE(items[1].score);
+
+	// chrono member is converted from DOM with timestamp conversions
+	const auto event = asyncnet::parse_json_as<Event>(R"({"items": [{"id": 3, "name": "c", "score": 1}], "duration": 60})");
+	REQUIRE(event.items.size() == 1);
+	REQUIRE(event.items[0].id == 3);
+	REQUIRE(event.duration == std::chrono::minutes(1));
+
+	REQUIRE_THROWS_AS(asyncnet::parse_json_as<std::vector<Item>>(R"([{"id": "x"}])"), boost::system::system_error);
+
+	// unknown keys are ignored like by value_to
+	const std::string_view extra_keys = R"([{"id": 4, "name": "d", "score": 2, "extra": {"a": [1]}}])";
+	const auto extra_items = asyncnet::parse_json_as<std::vector<Item>>(extra_keys);
+	REQUIRE(extra_items.size() == 1);
+	REQUIRE(extra_items[0].id == 4);
+	REQUIRE(extra_items[0].name == "d");
+	REQUIRE(extra_items[0].score == 2);
+	REQUIRE(boost::json::value_to<std::vector<Item>>(boost::json::parse(extra_keys))[0].id == 4);
+
+	// own conversion isn't bypassed
+	static_assert(!asyncnet::detail::parse_into_supported<Tag>);
+	REQUIRE(asyncnet::parse_json_as<std::vector<Tag>>(R"(["a", "b"])")[1].name == "b");
+
+	// conversions are the same as value_to ones
+	REQUIRE(asyncnet::parse_json_as<std::vector<Item>>(R"([{"id": 5.0, "name": "e", "score": null}])")[0].id == 5);
+	REQUIRE_THROWS_AS(asyncnet::parse_json_as<std::vector<Item>>(R"([{"id": 5.5, "name": "e", "score": null}])"), boost::system::system_error);
+	REQUIRE_THROWS_AS(asyncnet::parse_json_as<std::vector<Item>>(R"([{"id": 5, "score": null}])"), boost::system::system_error);
+	REQUIRE(asyncnet::parse_json_as<std::vector<Item>>(R"([{"id": 5, "name": "e"}])")[0].name == "e");
+}
+
+TEST_CASE("asyncnet::json parse as skips unknown keys in one pass") {
+	auto parse = [](std::string_view text, size_t& allocations) {
+		const size_t before = allocation_count;
+		auto items = asyncnet::parse_json_as<std::vector<Item>>(text);
+		allocations = allocation_count - before;
+		return items;
+	};
+
+	size_t known_allocations = 0;
+	const auto known_items = parse(R"([{"id": 1, "name": "a", "score": 0.5}])", known_allocations);
+
+	// values of unknown keys are skipped without allocating DOM or parsing the text again
+	size_t unknown_allocations = 0;
+	const auto unknown_items = parse(R"([{"id": 1, "extra": {"tags": ["long enough string to be allocated", "another long enough string"], "nested": [[1, 2], {"a": null}]}, "name": "a", "score": 0.5, "note": "long enough string to be allocated"}])", unknown_allocations);
+
+	REQUIRE(unknown_items.size() == 1);
+	REQUIRE(unknown_items[0].id == known_items[0].id);
+	REQUIRE(unknown_items[0].name == known_items[0].name);
+	REQUIRE(unknown_items[0].score == known_items[0].score);
+	REQUIRE(unknown_allocations == known_allocations);
+}
+
+TEST_CASE("asyncnet::json parse as JSON containers") {
+	static_assert(asyncnet::detail::json_storage_free<Event>);
+	static_assert(!asyncnet::detail::json_storage_free<boost::json::object>);
+	static_assert(!asyncnet::detail::json_storage_free<RawEvent>);
+
+	// result outlives the temporary document
+	const auto object = asyncnet::parse_json_as<boost::json::object>(R"({"a": [1, 2], "b": {"c": "long enough string to be allocated"}})");
+	REQUIRE(object.at("a").at(1) == 2);
+	REQUIRE(object.at("b").at("c") == "long enough string to be allocated");
+
+	const auto event = asyncnet::parse_json_as<RawEvent>(R"({"type": "update", "payload": {"ids": [1, 2, 3], "name": "long enough string to be allocated"}})");
+	REQUIRE(event.type == "update");
+	REQUIRE(event.payload.at("ids").at(2) == 3);
+	REQUIRE(event.payload.at("name") == "long enough string to be allocated");
+}
+
+TEST_CASE("asyncnet::json parse with reused parser") {
+	const auto storage = boost::json::make_shared_resource<boost::json::monotonic_resource>();
+	const boost::json::value value = asyncnet::parse_json(R"({"a": [1, 2]})", storage);
+	REQUIRE(value.storage() == storage);
+	REQUIRE(value.at("a").at(1) == 2);
+
+	REQUIRE_THROWS_AS(asyncnet::parse_json("{\"a\": "), boost::system::system_error);
+
+	// parser is usable after error
+	REQUIRE(asyncnet::parse_json_object(R"({"b": true})").at("b") == true);
+}
+
+TEST_CASE("asyncnet::json serialize") {
+	const Item item{ .id = 3, .name = "c", .score = 0.5 };
+	REQUIRE(boost::json::parse(asyncnet::serialize_json(item)) == boost::json::parse(R"({"id": 3, "name": "c", "score": 0.5})"));
+
+	// type with tag_invoke conversion is serialized through DOM
+	const Event event{ .items = { item }, .duration = std::chrono::seconds(7) };
+	REQUIRE(asyncnet::parse_json(asyncnet::serialize_json(event)).at("duration") == 7);
+
+	// output longer than the first buffer
+	const std::string text(1000, 'x');
+	REQUIRE(asyncnet::serialize_json(boost::json::value(text)) == '"' + text + '"');
+}
+
+TEST_CASE("asyncnet::json body source") {
+	auto read = [](asyncnet::JsonBodySource source) -> coro::task<std::vector<std::string>> {
+		std::vector<std::string> chunks;
+		while (auto chunk = co_await source()) {
+			chunks.push_back(std::move(*chunk));
+		}
+		co_return chunks;
+	};
+
+	const auto event = std::make_shared<const Event>(Event{ .items = { { .id = 1, .name = "a" }, { .id = 2, .name = "b", .score = 1.5 } }, .duration = std::chrono::seconds(9) });
+	const asyncnet::JsonBodySource source(event, 8);
+
+	// every copy starts from the first chunk
+	const auto chunks = coro::sync_wait(read(source));
+	REQUIRE(coro::sync_wait(read(source)) == chunks);
+
+	std::string text;
+	for (const std::string& chunk : chunks) {
+		REQUIRE(chunk.size() <= 8);
+		text += chunk;
+	}
+	REQUIRE(chunks.size() == (text.size() + 7) / 8);
+	REQUIRE(asyncnet::parse_json(text) == boost::json::value_from(*event));
+}
+
+TEST_CASE("asyncnet::json extract fields") {
+	const std::string_view text = R"({"meta": {"count": 2, "tags": ["x", "y"]}, "data": [{"id": 1, "skip": {"a": [1, 2]}}, {"id": 2, "name": "b"}], "a~b": {"c/d": null}})";
+
+	SECTION("whole text") {
+		const auto values = asyncnet::extract_json_fields(text, { "/data/1/name", "/meta/count", "/data/0/id", "/missing", "/a~0b/c~1d", "/meta/tags" });
+		REQUIRE(values.size() == 6);
+		REQUIRE(values[0] == boost::json::value("b"));
+		REQUIRE(values[1] == boost::json::value(2));
+		REQUIRE(values[2] == boost::json::value(1));
+		REQUIRE_FALSE(values[3]);
+		REQUIRE(values[4] == boost::json::value(nullptr));
+		REQUIRE(values[5] == boost::json::parse(R"(["x", "y"])"));
+	}
+
+	SECTION("nested pointers") {
+		const auto values = asyncnet::extract_json_fields(text, { "/meta/tags/1", "/meta", "" });
+		REQUIRE(values[0] == boost::json::value("y"));
+		REQUIRE(values[1] == boost::json::parse(R"({"count": 2, "tags": ["x", "y"]})"));
+		REQUIRE(values[2] == boost::json::parse(text));
+	}
+
+	SECTION("chunks") {
+		asyncnet::JsonFieldExtractor extractor({ "/data/0/id", "/meta/tags/0" });
+		for (size_t offset = 0; offset < text.size() && !extractor.done(); offset += 3) {
+			extractor.write(text.substr(offset, 3));
+		}
+		// the rest of text isn't parsed
+		REQUIRE(extractor.done());
+		const auto values = extractor.finish();
+		REQUIRE(values[0] == boost::json::value(1));
+		REQUIRE(values[1] == boost::json::value("x"));
+	}
+
+	SECTION("errors") {
+		REQUIRE_THROWS_AS(asyncnet::extract_json_fields(text, { "meta" }), std::invalid_argument);
+		REQUIRE_THROWS_AS(asyncnet::extract_json_fields(R"({"a": ])", { "/b" }), boost::system::system_error);
+		REQUIRE_THROWS_AS(asyncnet::extract_json_fields(R"({"a": 1)", { "/b" }), boost::system::system_error);
+	}
+}
+
+TEST_CASE("asyncnet::json NDJSON decoder") {
+	const std::string text = "{\"id\": 0, \"tags\": [\"a\", \"b\"]}\r\n\n  \n[1, 2]\n{\"id\": }\n\"last\"";
+
+	asyncnet::NdjsonDecoder decoder;
+	std::vector<boost::json::value> records;
+	size_t errors = 0;
+	auto take = [&] {
+		while (true) {
+			try {
+				auto record = decoder.next();
+				if (!record) {
+					return;
+				}
+				records.push_back(std::move(*record));
+			}
+			catch (const boost::system::system_error&) {
+				errors++;
+			}
+		}
+	};
+
+	const size_t chunk_size = GENERATE(1, 3, 100);
+	for (size_t offset = 0; offset < text.size(); offset += chunk_size) {
+		decoder.feed(text.substr(offset, chunk_size));
+		take();
+	}
+	if (auto last = decoder.finish()) {
+		records.push_back(std::move(*last));
+	}
+
+	// invalid record is skipped
+	REQUIRE(errors == 1);
+	REQUIRE(records.size() == 3);
+	REQUIRE(records[0] == boost::json::parse(R"({"id": 0, "tags": ["a", "b"]})"));
+	REQUIRE(records[1] == boost::json::parse("[1, 2]"));
+	REQUIRE(records[2] == boost::json::value("last"));
+	REQUIRE_FALSE(decoder.finish());
+}
+
+TEST_CASE("asyncnet::json NDJSON decoder move") {
+	static_assert(std::is_nothrow_move_constructible_v<asyncnet::NdjsonDecoder>);
+	static_assert(std::is_move_constructible_v<asyncnet::NdjsonStream>);
+
+	asyncnet::NdjsonDecoder decoder;
+	decoder.feed("{\"id\": ");
+	REQUIRE_FALSE(decoder.next());
+
+	// record split by the move is continued
+	asyncnet::NdjsonDecoder moved = std::move(decoder);
+	moved.feed("1}\n");
+	REQUIRE(moved.next() == boost::json::parse(R"({"id": 1})"));
+}
+
+#if ASYNCNET_USE_SIMDJSON
+TEST_CASE("asyncnet::json simdjson view") {
+	const std::string_view text = R"({"a": [1, -2, 3.5, 18446744073709551615], "b": {"c": "d\n"}, "e": true, "f": null})";
+
+	asyncnet::JsonView view(text);
+	REQUIRE(std::string_view(view.document()["b"]["c"]) == "d\n");
+
+	// conversion rewinds the document
+	REQUIRE(view.to_value() == boost::json::parse(text));
+}
+#endif
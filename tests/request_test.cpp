@@ -1,6 +1,7 @@
 #include "catch_amalgamated.hpp"
 
 #include <asyncnet/Requestor.hpp>
+#include <asyncnet/detail/Options.hpp>
 
 #include <curlpp/Options.hpp>
 #include <coro/sync_wait.hpp>
@@ -42,7 +43,7 @@ TEST_CASE("Request options set") {
 		curlpp::options::Url url_option;
 		curlpp::options::HttpHeader header_option;
 		curlpp::options::Verbose verbose_option;
-		curlpp::options::Timeout timeout_option;
+		asyncnet::detail::options::TimeoutMs timeout_option;
 		curlpp::options::FollowLocation follow_location_option;
 		curlpp::options::MaxRedirs max_redirs_option;
 
@@ -65,4 +66,123 @@ TEST_CASE("Request options set") {
 		REQUIRE(follow_location_option.getValue() == true);
 		REQUIRE(max_redirs_option.getValue() == -1);
 	}
-}
\ No newline at end of file
+}
+
+TEST_CASE("Request HTTP version") {
+	Request request("https://httpbin.org/get");
+	request.set_http_version(HttpVersion::Http2);
+
+	{
+		curlpp::Easy handle = request.make_request_handle();
+		curlpp::options::HttpVersion version_option;
+		handle.getOpt(version_option);
+		REQUIRE(version_option.getValue() == CURL_HTTP_VERSION_2TLS);
+	}
+
+	request.set_http_version(HttpVersion::Http2PriorKnowledge);
+
+	{
+		curlpp::Easy handle = request.make_request_handle();
+		curlpp::options::HttpVersion version_option;
+		handle.getOpt(version_option);
+		REQUIRE(version_option.getValue() == CURL_HTTP_VERSION_2_PRIOR_KNOWLEDGE);
+	}
+}
+
+TEST_CASE("Request timeouts") {
+	using namespace std::chrono_literals;
+
+	Request request("https://httpbin.org/get");
+	request.set_timeout(250ms);
+	request.set_connect_timeout(100us);
+	request.set_first_byte_timeout(1500ms);
+
+	{
+		curlpp::Easy handle = request.make_request_handle();
+		asyncnet::detail::options::TimeoutMs timeout_option;
+		asyncnet::detail::options::ConnectTimeoutMs connect_timeout_option;
+		handle.getOpt(timeout_option);
+		handle.getOpt(connect_timeout_option);
+		REQUIRE(timeout_option.getValue() == 250);
+		// rounded up, zero would mean no timeout
+		REQUIRE(connect_timeout_option.getValue() == 1);
+	}
+
+	const PerformOptions& options = request.get_perform_options();
+	REQUIRE(options.first_byte_timeout == 1500ms);
+	REQUIRE(!options.idle_timeout);
+
+	Request copy(request);
+	REQUIRE(copy.get_perform_options().first_byte_timeout == 1500ms);
+}
+
+TEST_CASE("Request priority") {
+	Request request("https://httpbin.org/get");
+	REQUIRE(request.get_perform_options().priority == RequestPriority::Normal);
+
+	request.set_priority(RequestPriority::Interactive);
+	REQUIRE(request.get_perform_options().priority == RequestPriority::Interactive);
+
+	request.set_tenant("customer");
+	Request copy(request);
+	REQUIRE(copy.get_perform_options().tenant == "customer");
+}
+
+TEST_CASE("Request streaming body") {
+	using namespace std::chrono_literals;
+
+	auto source = []() -> coro::task<std::optional<std::string>> {
+		co_return std::nullopt;
+	};
+
+	StreamingPostRequest request("https://httpbin.org/post", source);
+	REQUIRE(request.get_perform_options().body_source);
+
+	request.set_expect_continue(100ms);
+	{
+		curlpp::Easy handle = request.make_request_handle();
+		curlpp::options::PostFieldSizeLarge size_option;
+		asyncnet::detail::options::Expect100TimeoutMs expect_option;
+		handle.getOpt(size_option);
+		handle.getOpt(expect_option);
+		// unknown size makes chunked body
+		REQUIRE(size_option.getValue() == -1);
+		REQUIRE(expect_option.getValue() == 100);
+	}
+
+	StreamingPostRequest sized_request(request, "https://httpbin.org/post", source, 42);
+	sized_request.set_expect_continue(std::nullopt);
+	{
+		curlpp::Easy handle = sized_request.make_request_handle();
+		curlpp::options::PostFieldSizeLarge size_option;
+		curlpp::options::HttpHeader headers_option;
+		handle.getOpt(size_option);
+		handle.getOpt(headers_option);
+		REQUIRE(size_option.getValue() == 42);
+		REQUIRE(headers_option.getValue().back() == "Expect:");
+	}
+}
+
+TEST_CASE("Request JSON body") {
+	const boost::json::value body = { { "id", 1 }, { "name", "item" } };
+
+	Request base("https://httpbin.org/post");
+	base.set_headers({ "content-type: text/plain", "Accept: application/json" });
+	JsonPostRequest request(base, "https://httpbin.org/post", body);
+	const JsonPostRequest copy(request);
+
+	curlpp::Easy handle = copy.make_request_handle();
+	curlpp::options::PostFieldSizeLarge size_option;
+	curlpp::options::HttpHeader headers_option;
+	handle.getOpt(size_option);
+	handle.getOpt(headers_option);
+	REQUIRE(size_option.getValue() == static_cast<curl_off_t>(boost::json::serialize(body).size()));
+	// content type of the copied request is replaced
+	REQUIRE(headers_option.getValue() == std::list<std::string>{ "Accept: application/json", "Content-Type: application/json" });
+
+	// copied post fields are replaced by shared ones and back
+	PostRequest text_request(request, "https://httpbin.org/post", "text");
+	curlpp::Easy text_handle = text_request.make_request_handle();
+	text_handle.getOpt(size_option);
+	REQUIRE(size_option.getValue() == 4);
+}
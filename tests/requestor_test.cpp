@@ -1,9 +1,12 @@
 #include "catch_amalgamated.hpp"
+#include <asyncnet/NdjsonStream.hpp>
 #include <asyncnet/Requestor.hpp>
 #include <coro/sync_wait.hpp>
 #include <coro/when_all.hpp>
 #include <curlpp/Options.hpp>
+#include <algorithm>
 #include <print>
+#include <thread>
 
 #include <iostream>
 
@@ -17,6 +20,19 @@ TEST_CASE("Requestor copy, move") {
 	Requestor requestor3 = std::move(requestor);
 }
 
+TEST_CASE("Requestor event loop copy, move") {
+	Requestor requestor(2, RequestorEngine::EventLoop);
+	Requestor requestor2 = requestor;
+	Requestor requestor3 = std::move(requestor);
+}
+
+TEST_CASE("Requestor sharded copy, move") {
+	Requestor requestor(2, RequestorEngine::Sharded);
+	requestor.set_work_stealing(64);
+	Requestor requestor2 = requestor;
+	Requestor requestor3 = std::move(requestor);
+}
+
 #if defined(ASYNCNET_ENABLE_TESTS_NETWORK)
 
 TEST_CASE("NetworkRequestor request") {
@@ -47,6 +63,106 @@ TEST_CASE("NetworkRequestor request") {
 	REQUIRE_NOTHROW(std::get<1>(output_tasks).return_value());
 }
 
+TEST_CASE("NetworkRequestor event loop many requests") {
+	Requestor requestor(1, RequestorEngine::EventLoop);
+
+	auto worker = [](Requestor& requestor) -> coro::task<void> {
+		curlpp::Easy easy;
+		easy.setOpt(curlpp::options::Url("https://www.google.com/"));
+
+		auto resp = co_await requestor.perform_handle(std::move(easy));
+		REQUIRE(resp.get_status_code() == 200);
+	};
+
+	std::vector<coro::task<void>> tasks;
+	for (int i = 0; i < 16; i++) {
+		tasks.push_back(worker(requestor));
+	}
+
+	for (auto& task : coro::sync_wait(coro::when_all(std::move(tasks)))) {
+		REQUIRE_NOTHROW(task.return_value());
+	}
+}
+
+TEST_CASE("NetworkRequestor sharded host affinity") {
+	Requestor requestor(4, RequestorEngine::Sharded);
+
+	auto worker = [](Requestor& requestor) -> coro::task<std::thread::id> {
+		curlpp::Easy easy;
+		easy.setOpt(curlpp::options::Url("https://www.google.com/"));
+
+		auto resp = co_await requestor.perform_handle(std::move(easy));
+		REQUIRE(resp.get_status_code() == 200);
+		// resumed on the shard thread
+		co_return std::this_thread::get_id();
+	};
+
+	std::vector<coro::task<std::thread::id>> tasks;
+	for (int i = 0; i < 8; i++) {
+		tasks.push_back(worker(requestor));
+	}
+
+	auto results = coro::sync_wait(coro::when_all(std::move(tasks)));
+	const auto shard_thread_id = results.front().return_value();
+	for (auto& result : results) {
+		REQUIRE(result.return_value() == shard_thread_id);
+	}
+}
+
+TEST_CASE("NetworkRequestor perform streaming") {
+	auto engine = GENERATE(RequestorEngine::ThreadPool, RequestorEngine::EventLoop);
+	Requestor requestor(1, engine);
+
+	auto read = [](StreamingResponse response) -> coro::task<std::string> {
+		std::string body;
+		while (auto chunk = co_await response.next_chunk()) {
+			body += *chunk;
+		}
+		REQUIRE(response.get_status_code() == 200);
+		co_return body;
+	};
+
+	// small buffer pauses the transfer between chunks
+	const auto body = coro::sync_wait(read(requestor.perform_streaming(Request("https://www.google.com/"), 1024)));
+	REQUIRE_FALSE(body.empty());
+}
+
+TEST_CASE("NetworkRequestor perform streaming NDJSON") {
+	auto engine = GENERATE(RequestorEngine::ThreadPool, RequestorEngine::EventLoop);
+	Requestor requestor(1, engine);
+
+	auto read = [](NdjsonStream stream) -> coro::task<std::vector<int64_t>> {
+		std::vector<int64_t> ids;
+		while (auto record = co_await stream.next()) {
+			ids.push_back(record->at("id").to_number<int64_t>());
+		}
+		REQUIRE(stream.get_status_code() == 200);
+		co_return ids;
+	};
+
+	// records are split by small chunks
+	const auto ids = coro::sync_wait(read(NdjsonStream(requestor.perform_streaming(Request("https://httpbin.org/stream/5"), 64))));
+	REQUIRE(ids == std::vector<int64_t>{ 0, 1, 2, 3, 4 });
+}
+
+TEST_CASE("NetworkRequestor perform streaming cancel") {
+	Requestor requestor(1, RequestorEngine::EventLoop);
+
+	auto read = [](StreamingResponse response) -> coro::task<void> {
+		REQUIRE(co_await response.next_chunk());
+		response.request_stop();
+		try {
+			while (co_await response.next_chunk()) {
+			}
+		}
+		catch (const NetworkRuntimeError& error) {
+			REQUIRE(error.whatCode() == CancelledErrorCode);
+		}
+	};
+
+	coro::sync_wait(read(requestor.perform_streaming(Request("https://www.google.com/"), 1024)));
+}
+
 #endif
 
 TEST_CASE("NetworkRequestor custom pool") {
@@ -71,4 +187,109 @@ TEST_CASE("NetworkRequestor custom pool") {
 	};
 
 	coro::sync_wait(worker(requestor, pool));
-}
\ No newline at end of file
+}
+
+TEST_CASE("NetworkRequestor event loop custom pool") {
+	auto pool = coro::thread_pool::make_shared(coro::thread_pool::options{
+		.thread_count = 1
+	});
+
+	Requestor requestor(1, pool, RequestorEngine::EventLoop);
+
+	auto worker = [](Requestor& requestor, std::shared_ptr<coro::thread_pool> pool) -> coro::task<void> {
+		co_await pool->schedule();
+		auto pool_thread_id = std::this_thread::get_id();
+
+		curlpp::Easy easy;
+
+		easy.setOpt(curlpp::options::Url(""));
+
+		REQUIRE_THROWS_AS(co_await requestor.perform_handle(std::move(easy)), NetworkRuntimeError);
+
+		auto after_thread_id = std::this_thread::get_id();
+		REQUIRE(pool_thread_id == after_thread_id);
+	};
+
+	coro::sync_wait(worker(requestor, pool));
+}
+
+TEST_CASE("Requestor perform many") {
+	auto engine = GENERATE(RequestorEngine::ThreadPool, RequestorEngine::EventLoop, RequestorEngine::Sharded);
+	Requestor requestor(2, engine);
+
+	// requests without URL fail at once, so the batch is done without network
+	std::vector<Request> requests(8);
+	auto results = coro::sync_wait(requestor.perform_many(requests));
+
+	REQUIRE(results.size() == requests.size());
+	for (size_t i = 0; i < results.size(); i++) {
+		REQUIRE(results[i].index == i);
+		REQUIRE_FALSE(results[i].response);
+		REQUIRE_THROWS_AS(std::rethrow_exception(results[i].error), NetworkRuntimeError);
+	}
+
+	REQUIRE(coro::sync_wait(requestor.perform_many(std::vector<Request>())).empty());
+}
+
+TEST_CASE("Requestor perform many stream") {
+	auto engine = GENERATE(RequestorEngine::ThreadPool, RequestorEngine::EventLoop);
+	Requestor requestor(2, engine);
+
+	auto consume = [](ResponseStream stream) -> coro::task<std::vector<size_t>> {
+		std::vector<size_t> indexes;
+		while (!stream.done()) {
+			auto results = co_await stream.next();
+			REQUIRE_FALSE(results.empty());
+			for (const auto& result : results) {
+				indexes.push_back(result.index);
+			}
+		}
+		REQUIRE((co_await stream.next()).empty());
+		co_return indexes;
+	};
+
+	std::vector<Request> requests(8);
+	auto indexes = coro::sync_wait(consume(requestor.perform_many_stream(requests)));
+
+	std::ranges::sort(indexes);
+	REQUIRE(indexes == std::vector<size_t>{ 0, 1, 2, 3, 4, 5, 6, 7 });
+}
+
+TEST_CASE("Requestor perform streaming failure") {
+	auto engine = GENERATE(RequestorEngine::ThreadPool, RequestorEngine::EventLoop);
+	Requestor requestor(1, engine);
+
+	auto read = [](StreamingResponse response) -> coro::task<void> {
+		REQUIRE_THROWS_AS(co_await response.next_chunk(), NetworkRuntimeError);
+	};
+
+	coro::sync_wait(read(requestor.perform_streaming(Request())));
+}
+
+#if defined(__linux__)
+
+TEST_CASE("NetworkRequestor io scheduler") {
+	auto scheduler = coro::io_scheduler::make_shared(coro::io_scheduler::options{
+		.execution_strategy = coro::io_scheduler::execution_strategy_t::process_tasks_inline
+	});
+
+	Requestor requestor(scheduler);
+
+	auto worker = [](Requestor& requestor, std::shared_ptr<coro::io_scheduler> scheduler) -> coro::task<void> {
+		co_await scheduler->schedule();
+		auto scheduler_thread_id = std::this_thread::get_id();
+
+		curlpp::Easy easy;
+
+		easy.setOpt(curlpp::options::Url(""));
+
+		REQUIRE_THROWS_AS(co_await requestor.perform_handle(std::move(easy)), NetworkRuntimeError);
+
+		auto after_thread_id = std::this_thread::get_id();
+		REQUIRE(scheduler_thread_id == after_thread_id);
+	};
+
+	coro::sync_wait(worker(requestor, scheduler));
+}
+
+#endif
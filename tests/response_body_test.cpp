@@ -0,0 +1,169 @@
+#include "catch_amalgamated.hpp"
+#include <asyncnet/Response.hpp>
+#include <asyncnet/ResponseBody.hpp>
+
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#pragma execution_character_set("utf-8")
+
+using namespace asyncnet;
+
+namespace {
+	std::string join_chunks(const ResponseBody& body) {
+		std::string text;
+		for (const std::string_view chunk : body.chunks()) {
+			text.append(chunk);
+		}
+		return text;
+	}
+}
+
+TEST_CASE("ResponseBody inline") {
+	ResponseBody body;
+	REQUIRE(body.empty());
+	REQUIRE(body.view().empty());
+	REQUIRE(body.chunks().empty());
+
+	body.append("hello ", 6);
+	body.append("world", 5);
+	REQUIRE(body.size() == 11);
+	REQUIRE(body.view() == "hello world");
+	REQUIRE(body.chunks().size() == 1);
+
+	ResponseBody moved_body(std::move(body));
+	REQUIRE(body.empty());
+	REQUIRE(moved_body.release() == "hello world");
+	REQUIRE(moved_body.empty());
+}
+
+TEST_CASE("ResponseBody slabs") {
+	std::string text;
+	for (size_t i = 0; text.size() < ResponseBody::slab_size * 3; i++) {
+		text += std::to_string(i);
+	}
+
+	ResponseBody body;
+	for (size_t offset = 0; offset < text.size(); offset += 1000) {
+		const std::string_view part = std::string_view(text).substr(offset, 1000);
+		body.append(part.data(), part.size());
+	}
+
+	REQUIRE(body.size() == text.size());
+	REQUIRE(body.chunks().size() == 4);
+	REQUIRE(join_chunks(body) == text);
+
+	// slabs are kept after finish, so chunks are still read without copying
+	const std::vector<std::string_view> chunks = body.chunks();
+	body.finish();
+	REQUIRE(body.chunks().size() == chunks.size());
+	REQUIRE(body.chunks().back().data() == chunks.back().data());
+
+	// joined once on the first view of the whole body, also from several threads
+	std::vector<std::string_view> views(4);
+	std::vector<std::thread> threads;
+	for (std::string_view& view : views) {
+		threads.emplace_back([&body, &view]() {
+			view = body.view();
+		});
+	}
+	for (std::thread& thread : threads) {
+		thread.join();
+	}
+	const std::string_view view = body.view();
+	REQUIRE(view == text);
+	for (const std::string_view thread_view : views) {
+		REQUIRE(thread_view.data() == view.data());
+	}
+	REQUIRE(body.chunks().size() == chunks.size());
+
+	REQUIRE(body.release() == text);
+	REQUIRE(body.empty());
+}
+
+TEST_CASE("ResponseBody reserve") {
+	const std::string text(1000, 'a');
+
+	ResponseBody body;
+	body.reserve(text.size());
+	body.append(text.data(), 500);
+	const char* data = body.view().data();
+	body.append(text.data() + 500, 500);
+	REQUIRE(body.view().data() == data);
+	REQUIRE(body.chunks().size() == 1);
+
+	// data above reserved capacity goes to slabs, so the head isn't reallocated
+	const std::string tail(ResponseBody::slab_size, 'b');
+	body.append(tail.data(), tail.size());
+	REQUIRE(body.chunks().size() >= 2);
+	REQUIRE(body.chunks().front().data() == data);
+	REQUIRE(join_chunks(body) == text + tail);
+
+	body.finish();
+	REQUIRE(body.view() == text + tail);
+
+	std::string released = body.release();
+	REQUIRE(released == text + tail);
+}
+
+TEST_CASE("ResponseBody padded view") {
+	const std::string text(ResponseBody::slab_size + 1, 'a');
+
+	ResponseBody body;
+	body.append(text.data(), text.size());
+	REQUIRE_THROWS_AS(body.padded_view(), std::logic_error);
+	body.finish();
+	const std::string_view view = body.padded_view();
+	REQUIRE(view == text);
+	REQUIRE(std::string_view(view.data() + view.size(), ResponseBody::tail_padding) == std::string(ResponseBody::tail_padding, '\0'));
+
+	// views of finished body stay stable
+	REQUIRE(body.padded_view().data() == view.data());
+	REQUIRE(body.view().data() == view.data());
+	REQUIRE(body.chunks().size() == 2);
+	REQUIRE(join_chunks(body) == text);
+
+	ResponseBody reserved_body;
+	reserved_body.reserve(1000);
+	reserved_body.append(text.data(), 1000);
+	const char* const data = reserved_body.view().data();
+	reserved_body.finish();
+	REQUIRE(reserved_body.padded_view().data() == data);
+	REQUIRE(reserved_body.padded_view() == text.substr(0, 1000));
+
+	ResponseBody inline_body;
+	inline_body.append(text.data(), 10);
+	inline_body.finish();
+	const std::string_view inline_view = inline_body.padded_view();
+	REQUIRE(inline_view == text.substr(0, 10));
+	REQUIRE(std::string_view(inline_view.data() + inline_view.size(), ResponseBody::tail_padding) == std::string(ResponseBody::tail_padding, '\0'));
+
+	// appending after finish drops the padding
+	body.append("b", 1);
+	REQUIRE(body.size() == text.size() + 1);
+	REQUIRE(join_chunks(body) == text + "b");
+	REQUIRE(body.release() == text + "b");
+}
+
+TEST_CASE("ResponseBody of response") {
+	const std::string text(ResponseBody::slab_size * 2, 'a');
+
+	ResponseBody body;
+	body.append(text.data(), text.size());
+	const std::vector<std::string_view> chunks = body.chunks();
+	REQUIRE(chunks.size() > 1);
+
+	// response keeps the slabs, so its body is read by chunks without joining
+	const Response response(curlpp::Easy(), std::move(body), ResponseHeaders());
+	const std::vector<std::string_view> response_chunks = response.get_body().chunks();
+	REQUIRE(response_chunks.size() == chunks.size());
+	for (size_t i = 0; i < chunks.size(); i++) {
+		REQUIRE(response_chunks[i].data() == chunks[i].data());
+	}
+	REQUIRE(join_chunks(response.get_body()) == text);
+
+	REQUIRE(response.get_text_view() == text);
+	REQUIRE(response.get_body().padded_view().data() == response.get_text_view().data());
+}
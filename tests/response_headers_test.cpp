@@ -0,0 +1,57 @@
+#include "catch_amalgamated.hpp"
+#include <asyncnet/ResponseHeaders.hpp>
+
+#include <string_view>
+
+#pragma execution_character_set("utf-8")
+
+using namespace asyncnet;
+
+namespace {
+	void append(ResponseHeaders& headers, const std::string_view line) {
+		headers.append_line(line.data(), line.size());
+	}
+}
+
+TEST_CASE("ResponseHeaders lookup") {
+	ResponseHeaders headers;
+	append(headers, "HTTP/1.1 200 OK\r\n");
+	append(headers, "content-type: application/json\r\n");
+	append(headers, "Set-Cookie: a=1\r\n");
+	append(headers, "X-Request-Id:   abc \r\n");
+	append(headers, "set-cookie: b=2\r\n");
+	append(headers, "\r\n");
+
+	REQUIRE(headers.size() == 4);
+	REQUIRE(headers.at(0).name == "content-type");
+	REQUIRE(headers.at(0).value == "application/json");
+	REQUIRE_THROWS_AS(headers.at(4), std::out_of_range);
+
+	REQUIRE(headers.get(HeaderName::ContentType) == "application/json");
+	REQUIRE(headers.get("Content-Type") == "application/json");
+	REQUIRE(headers.get("x-request-id") == "abc");
+	REQUIRE(headers.get("SET-COOKIE") == "a=1");
+	REQUIRE(headers.get_all("Set-Cookie") == std::vector<std::string_view>{ "a=1", "b=2" });
+
+	REQUIRE_FALSE(headers.get(HeaderName::Location));
+	REQUIRE_FALSE(headers.get("X-Missing"));
+	REQUIRE_FALSE(headers.contains("Location"));
+	REQUIRE(headers.contains("X-Request-Id"));
+}
+
+TEST_CASE("ResponseHeaders final response") {
+	ResponseHeaders headers;
+	append(headers, "HTTP/1.1 100 Continue\r\n");
+	append(headers, "\r\n");
+	append(headers, "HTTP/1.1 302 Found\r\n");
+	append(headers, "Location: /next\r\n");
+	append(headers, "\r\n");
+	append(headers, "HTTP/2 200\r\n");
+	append(headers, "content-length: 2\r\n");
+	append(headers, "\r\n");
+
+	// headers of redirect response are dropped
+	REQUIRE(headers.size() == 1);
+	REQUIRE_FALSE(headers.get(HeaderName::Location));
+	REQUIRE(headers.get(HeaderName::ContentLength) == "2");
+}
@@ -4,7 +4,9 @@
 #include <asyncnet/NetworkTask.hpp>
 
 #include <coro/sync_wait.hpp>
+#include <coro/when_all.hpp>
 #include <print>
+#include <thread>
 
 #pragma execution_character_set("utf-8")
 
@@ -36,8 +38,76 @@ TEST_CASE("AsyncSession cancellation") {
 	coro::sync_wait(worker(session));
 }
 
+TEST_CASE("AsyncSession event loop cancellation") {
+	AsyncSession session(1, RequestorEngine::EventLoop);
+
+	auto worker = [](AsyncSession& session) -> coro::task<void> {
+		auto request = session.make_request<GetRequest>("https://google.com");
+
+		auto task = session.perform_request(request);
+		// should never be submitted to the loop
+		task.request_stop();
+
+		try {
+			co_await task;
+			REQUIRE(false);
+		}
+		catch (const NetworkRuntimeError& e) {
+			REQUIRE(e.whatCode() == CancelledErrorCode);
+		}
+	};
+
+	coro::sync_wait(worker(session));
+}
+
 #ifdef ASYNCNET_ENABLE_TESTS_NETWORK
 
+TEST_CASE("AsyncSession running request cancellation") {
+	AsyncSession session(1, RequestorEngine::EventLoop);
+
+	auto worker = [](AsyncSession& session) -> coro::task<void> {
+		auto task = session.perform_request(session.make_request<GetRequest>("https://httpbin.org/delay/10"));
+
+		std::jthread stopper([&task] {
+			std::this_thread::sleep_for(std::chrono::milliseconds(200));
+			task.request_stop();
+		});
+
+		const auto start = std::chrono::steady_clock::now();
+		try {
+			co_await task;
+			REQUIRE(false);
+		}
+		catch (const NetworkRuntimeError& e) {
+			REQUIRE(e.whatCode() == CancelledErrorCode);
+		}
+		REQUIRE(std::chrono::steady_clock::now() - start < std::chrono::seconds(5));
+	};
+
+	coro::sync_wait(worker(session));
+}
+
+TEST_CASE("AsyncSession first byte timeout") {
+	auto engine = GENERATE(RequestorEngine::EventLoop, RequestorEngine::ThreadPool);
+	AsyncSession session(1, engine);
+	session.set_first_byte_timeout(std::chrono::milliseconds(500));
+
+	auto worker = [](AsyncSession& session) -> coro::task<void> {
+		const auto start = std::chrono::steady_clock::now();
+		try {
+			co_await session.perform_request(session.make_request<GetRequest>("https://httpbin.org/delay/10"));
+			REQUIRE(false);
+		}
+		catch (const TimeoutError& e) {
+			REQUIRE(e.whatCode() == TimeoutErrorCode);
+			REQUIRE(e.kind() == TimeoutKind::FirstByte);
+		}
+		REQUIRE(std::chrono::steady_clock::now() - start < std::chrono::seconds(5));
+	};
+
+	coro::sync_wait(worker(session));
+}
+
 TEST_CASE("AsyncSession GET request") {
 	AsyncSession session(1);
 
@@ -57,6 +127,7 @@ TEST_CASE("AsyncSession GET request") {
 		// REQUIRE_NOTHROW
 		auto resp = co_await session.perform_request(request);
 		CHECK(resp.get_status_code() == 200);
+		CHECK(resp.get_header("content-type") == "application/json");
 
 		boost::json::object resp_object = parse_json_object(resp.get_text());
 		INFO(resp_object);
@@ -94,6 +165,67 @@ TEST_CASE("AsyncSession POST request") {
 	coro::sync_wait(worker(session));
 }
 
+TEST_CASE("AsyncSession JSON body mode") {
+	auto engine = GENERATE(RequestorEngine::EventLoop, RequestorEngine::ThreadPool);
+	AsyncSession session(1, engine);
+
+	auto worker = [](AsyncSession& session) -> coro::task<void> {
+		auto request = session.make_request<GetRequest>("https://httpbin.org/get");
+		request.set_url_parameters({
+			{ "test", "test1" }
+		});
+		request.set_body_mode(ResponseBodyMode::Json);
+
+		auto resp = co_await session.perform_request(request);
+		CHECK(resp.get_status_code() == 200);
+		REQUIRE(resp.get_text().empty());
+		REQUIRE(resp.get_json().at("args").at("test") == "test1");
+
+		// body, which isn't JSON, is kept as text with the status
+		auto html_request = session.make_request<GetRequest>("https://httpbin.org/html");
+		html_request.set_body_mode(ResponseBodyMode::Json);
+		auto html_resp = co_await session.perform_request(html_request);
+		CHECK(html_resp.get_status_code() == 200);
+		REQUIRE(html_resp.get_text().find("<html>") != std::string::npos);
+		REQUIRE_FALSE(html_resp.get_json_error());
+		REQUIRE_THROWS_AS(html_resp.get_json(), std::logic_error);
+
+		auto error_request = session.make_request<GetRequest>("https://httpbin.org/status/404");
+		error_request.set_body_mode(ResponseBodyMode::Json);
+		auto error_resp = co_await session.perform_request(error_request);
+		CHECK(error_resp.get_status_code() == 404);
+	};
+
+	coro::sync_wait(worker(session));
+}
+
+TEST_CASE("AsyncSession streaming POST request") {
+	auto engine = GENERATE(RequestorEngine::EventLoop, RequestorEngine::ThreadPool);
+	AsyncSession session(1, engine);
+
+	auto worker = [](AsyncSession& session) -> coro::task<void> {
+		auto source = [chunk = 0]() mutable -> coro::task<std::optional<std::string>> {
+			if (chunk == 3) {
+				co_return std::nullopt;
+			}
+			co_return std::format("line{}\n", chunk++);
+		};
+
+		auto request = session.make_request<StreamingPostRequest>("https://httpbin.org/post", source);
+		request.set_expect_continue(std::nullopt);
+		request.add_headers({ "Content-Type: text/plain" });
+
+		auto resp = co_await session.perform_request(request);
+		CHECK(resp.get_status_code() == 200);
+
+		boost::json::object resp_object = parse_json_object(resp.get_text());
+		INFO(resp_object);
+		REQUIRE(resp_object["data"].as_string() == "line0\nline1\nline2\n");
+	};
+
+	coro::sync_wait(worker(session));
+}
+
 TEST_CASE("AsyncSession HEAD request") {
 	AsyncSession session(1);
 
@@ -138,4 +270,68 @@ TEST_CASE("AsyncSession multipart POST request") {
 	coro::sync_wait(worker(session));
 }
 
+TEST_CASE("AsyncSession HTTP/2 multiplexing") {
+	AsyncSession session(1, RequestorEngine::EventLoop);
+	session.set_http_version(HttpVersion::Http2);
+	session.set_max_concurrent_streams(16);
+
+	auto worker = [](AsyncSession& session) -> coro::task<void> {
+		auto resp = co_await session.perform_request(session.make_request<GetRequest>("https://httpbin.org/get"));
+		REQUIRE(resp.get_status_code() == 200);
+	};
+
+	std::vector<coro::task<void>> tasks;
+	for (int i = 0; i < 8; i++) {
+		tasks.push_back(worker(session));
+	}
+	coro::sync_wait(coro::when_all(std::move(tasks)));
+
+	// parallel requests wait for the first connection and multiplex on it
+	const auto statistics = session.get_connection_pool()->statistics();
+	REQUIRE(statistics.connection_misses == 1);
+	REQUIRE(statistics.connection_hits == 7);
+}
+
+TEST_CASE("AsyncSession warm up") {
+	AsyncSession session(1, RequestorEngine::EventLoop);
+
+	auto results = coro::sync_wait(session.warm_up({ "https://httpbin.org" }, 2));
+	REQUIRE(results.size() == 1);
+	REQUIRE_FALSE(results[0].error);
+	REQUIRE(results[0].origin == "https://httpbin.org");
+	REQUIRE(results[0].connections == 2);
+	REQUIRE(results[0].tls_time > std::chrono::microseconds(0));
+
+	auto worker = [](AsyncSession& session) -> coro::task<void> {
+		auto resp = co_await session.perform_request(session.make_request<GetRequest>("https://httpbin.org/get"));
+		REQUIRE(resp.get_status_code() == 200);
+	};
+	coro::sync_wait(worker(session));
+
+	REQUIRE(session.get_connection_pool()->statistics().connection_hits == 1);
+}
+
+TEST_CASE("AsyncSession warm up every loop") {
+	const unsigned loop_count = 4;
+	const auto engine = GENERATE(RequestorEngine::EventLoop, RequestorEngine::Sharded);
+	AsyncSession session(loop_count, engine);
+
+	auto results = coro::sync_wait(session.warm_up({ "https://httpbin.org" }, 2));
+	REQUIRE(results.size() == 1);
+	REQUIRE_FALSE(results[0].error);
+	// sharded origin is served only by its own shard
+	REQUIRE(results[0].connections == (engine == RequestorEngine::Sharded ? 2 : 2 * loop_count));
+
+	auto worker = [](AsyncSession& session) -> coro::task<void> {
+		auto resp = co_await session.perform_request(session.make_request<GetRequest>("https://httpbin.org/get"));
+		REQUIRE(resp.get_status_code() == 200);
+	};
+	// requests go to every loop in turn, and every loop has warm connection
+	for (unsigned i = 0; i < loop_count; i++) {
+		coro::sync_wait(worker(session));
+	}
+
+	REQUIRE(session.get_connection_pool()->statistics().connection_hits == loop_count);
+}
+
 #endif
\ No newline at end of file